@@ -0,0 +1,98 @@
+/*******************************************************************************
+*
+* File fastmath.h
+*
+* This software is distributed under the terms of the GNU General Public
+* License (GPL)
+*
+* Includes inline approximations of the elementary functions used by the
+* random number samplers (see rng_gauss.c and heatbath.c):
+*
+* double fast_log(double x)
+*      Returns log(x) for positive normalised x, within one unit in the
+*      last place of the C library.
+*
+* void fast_sincos2pi(double u,double *s,double *c)
+*      Sets *s=sin(2*pi*u) and *c=cos(2*pi*u) for 0<=u<=1, with an absolute
+*      error below 1e-15.
+*
+* The rational and polynomial approximations are those of the Cephes
+* library. They contain no branches or calls, the case distinctions are
+* done with bit masks, so that loops over these functions are vectorised
+* by the compiler. This requires that sqrt and the other functions of the
+* loop do not set errno (-fno-math-errno, see the Makefiles).
+*
+*******************************************************************************/
+
+#define FASTMATH_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define FM_TWO52 4503599627370496.0
+
+static inline double fm_double(uint64_t b)
+{
+   double x;
+
+   memcpy(&x,&b,sizeof(x));
+   return x;
+}
+
+static inline uint64_t fm_bits(double x)
+{
+   uint64_t b;
+
+   memcpy(&b,&x,sizeof(b));
+   return b;
+}
+
+static inline double fast_log(double x)
+{
+   uint64_t b,sw;
+   double m,f,z,e,p,d,y;
+
+   /* x=2^e*m with m in [1/sqrt(2),sqrt(2)), the exponent is converted
+    * through the mantissa of 2^52 */
+   b=fm_bits(x);
+   e=fm_double((b>>52)|0x4330000000000000ULL)-(FM_TWO52+1022.0);
+   sw=0-(uint64_t)((b&0x000fffffffffffffULL)<0x0006a09e667f3bcdULL);
+   e-=fm_double(sw&0x3ff0000000000000ULL);
+   m=fm_double((b&0x000fffffffffffffULL)|0x3fe0000000000000ULL);
+   f=m-1.0+fm_double(fm_bits(m)&sw);
+
+   z=f*f;
+   p=((((1.01875663804580931796E-4*f+4.97494994976747001425E-1)*f
+        +4.70579119878881725854E0)*f+1.44989225341610930846E1)*f
+        +1.79368678507819816313E1)*f+7.70838733755885391666E0;
+   d=((((f+1.12873587189167450590E1)*f+4.52279145837532221105E1)*f
+        +8.29875266912776603211E1)*f+7.11544750618563894466E1)*f
+        +2.31251620126765340583E1;
+   y=f*(z*p/d)-e*2.121944400546905827679E-4-0.5*z;
+
+   return f+y+e*0.693359375;
+}
+
+static inline void fast_sincos2pi(double u,double *s,double *c)
+{
+   uint64_t b,sw;
+   double t,x,z,sx,cx;
+
+   /* 2*pi*u=x+q*pi/2 with |x|<=pi/4, q is held in the last bits of t */
+   t=4.0*u+FM_TWO52;
+   b=fm_bits(t);
+   x=6.28318530717958647693*(u-0.25*(t-FM_TWO52));
+
+   z=x*x;
+   sx=x+x*z*(((((1.58962301576546568060E-10*z-2.50507477628578072866E-8)*z
+                +2.75573136213857245213E-6)*z-1.98412698295895385996E-4)*z
+                +8.33333333332211858878E-3)*z-1.66666666666666307295E-1);
+   cx=1.0-0.5*z+z*z*(((((-1.13585365213876817300E-11*z+2.08757008419747316778E-9)*z
+                        -2.75573141792967388112E-7)*z+2.48015872888517045348E-5)*z
+                        -1.38888888888730564116E-3)*z+4.16666666666665929218E-2);
+
+   /* odd q swaps sine and cosine, the signs follow from q mod 4 */
+   sw=0-(b&1);
+   (*s)=fm_double(((fm_bits(cx)&sw)|(fm_bits(sx)&~sw))^((b&2)<<62));
+   (*c)=fm_double(((fm_bits(sx)&sw)|(fm_bits(cx)&~sw))^(((b+1)&2)<<62));
+}
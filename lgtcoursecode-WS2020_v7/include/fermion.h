@@ -37,6 +37,18 @@ typedef struct
    su3vec d1,d2,d3,d4;
 } su3wferm;
 
+/* half spinors, the upper two spin components of (1-+gamma_mu)*w, from which
+ * the lower two are reconstructed (see the projection macros below) */
+typedef struct
+{
+   su2vec d1,d2;
+} su2hferm;
+
+typedef struct
+{
+   su3vec d1,d2;
+} su3hferm;
+
 /* SU(2) vector macros */
 
 /* v=i*w */
@@ -95,6 +107,34 @@ typedef struct
         (r).c2.re=(c)*(s).c2.re; \
         (r).c2.im=(c)*(s).c2.im;}
 
+/* r=s1+i*s2 */
+#define su2vec_add_i(r,s1,s2){ \
+        (r).c1.re=(s1).c1.re-(s2).c1.im; \
+        (r).c1.im=(s1).c1.im+(s2).c1.re; \
+        (r).c2.re=(s1).c2.re-(s2).c2.im; \
+        (r).c2.im=(s1).c2.im+(s2).c2.re;}
+
+/* r+=i*s */
+#define su2vec_add_i_single(r,s){ \
+        (r).c1.re-=(s).c1.im; \
+        (r).c1.im+=(s).c1.re; \
+        (r).c2.re-=(s).c2.im; \
+        (r).c2.im+=(s).c2.re;}
+
+/* r=s1-i*s2 */
+#define su2vec_sub_i(r,s1,s2){ \
+        (r).c1.re=(s1).c1.re+(s2).c1.im; \
+        (r).c1.im=(s1).c1.im-(s2).c1.re; \
+        (r).c2.re=(s1).c2.re+(s2).c2.im; \
+        (r).c2.im=(s1).c2.im-(s2).c2.re;}
+
+/* r-=i*s */
+#define su2vec_sub_i_single(r,s){ \
+        (r).c1.re+=(s).c1.im; \
+        (r).c1.im-=(s).c1.re; \
+        (r).c2.re+=(s).c2.im; \
+        (r).c2.im-=(s).c2.re;}
+
 /* r=u*s (u: SU(2) matrix; s: SU(2) vector) */
 #define su2vec_su2_mult(r,u,s){ \
         (r).c1.re= (u).c0*(s).c1.re-(u).c3*(s).c1.im+(u).c2*(s).c2.re-(u).c1*(s).c2.im; \
@@ -224,6 +264,145 @@ typedef struct
         su2vec_su2_dag_mult((v).d3,u,(w).d3); \
         su2vec_su2_dag_mult((v).d4,u,(w).d4);}
 
+/* r=0 */
+#define su2wferm_zero(r){ \
+        (r).d1.c1.re=0.0; \
+        (r).d1.c1.im=0.0; \
+        (r).d1.c2.re=0.0; \
+        (r).d1.c2.im=0.0; \
+        (r).d2.c1.re=0.0; \
+        (r).d2.c1.im=0.0; \
+        (r).d2.c2.re=0.0; \
+        (r).d2.c2.im=0.0; \
+        (r).d3.c1.re=0.0; \
+        (r).d3.c1.im=0.0; \
+        (r).d3.c2.re=0.0; \
+        (r).d3.c2.im=0.0; \
+        (r).d4.c1.re=0.0; \
+        (r).d4.c1.im=0.0; \
+        (r).d4.c2.re=0.0; \
+        (r).d4.c2.im=0.0;}
+
+/* h=upper half of (1-gamma_0)*w */
+#define su2wferm_proj_m0(h,w){ \
+        su2vec_add((h).d1,(w).d1,(w).d3); \
+        su2vec_add((h).d2,(w).d2,(w).d4);}
+
+/* h=upper half of (1+gamma_0)*w */
+#define su2wferm_proj_p0(h,w){ \
+        su2vec_sub((h).d1,(w).d1,(w).d3); \
+        su2vec_sub((h).d2,(w).d2,(w).d4);}
+
+/* h=upper half of (1-gamma_1)*w */
+#define su2wferm_proj_m1(h,w){ \
+        su2vec_add_i((h).d1,(w).d1,(w).d4); \
+        su2vec_add_i((h).d2,(w).d2,(w).d3);}
+
+/* h=upper half of (1+gamma_1)*w */
+#define su2wferm_proj_p1(h,w){ \
+        su2vec_sub_i((h).d1,(w).d1,(w).d4); \
+        su2vec_sub_i((h).d2,(w).d2,(w).d3);}
+
+/* h=upper half of (1-gamma_2)*w */
+#define su2wferm_proj_m2(h,w){ \
+        su2vec_add((h).d1,(w).d1,(w).d4); \
+        su2vec_sub((h).d2,(w).d2,(w).d3);}
+
+/* h=upper half of (1+gamma_2)*w */
+#define su2wferm_proj_p2(h,w){ \
+        su2vec_sub((h).d1,(w).d1,(w).d4); \
+        su2vec_add((h).d2,(w).d2,(w).d3);}
+
+/* h=upper half of (1-gamma_3)*w */
+#define su2wferm_proj_m3(h,w){ \
+        su2vec_add_i((h).d1,(w).d1,(w).d3); \
+        su2vec_sub_i((h).d2,(w).d2,(w).d4);}
+
+/* h=upper half of (1+gamma_3)*w */
+#define su2wferm_proj_p3(h,w){ \
+        su2vec_sub_i((h).d1,(w).d1,(w).d3); \
+        su2vec_add_i((h).d2,(w).d2,(w).d4);}
+
+/* r+=(1-gamma_0)*w, given its upper half h (proj_m0) */
+#define su2wferm_recon_add_m0(r,h){ \
+        su2vec_add_single((r).d1,(h).d1); \
+        su2vec_add_single((r).d2,(h).d2); \
+        su2vec_add_single((r).d3,(h).d1); \
+        su2vec_add_single((r).d4,(h).d2);}
+
+/* r+=(1+gamma_0)*w, given its upper half h (proj_p0) */
+#define su2wferm_recon_add_p0(r,h){ \
+        su2vec_add_single((r).d1,(h).d1); \
+        su2vec_add_single((r).d2,(h).d2); \
+        su2vec_sub_single((r).d3,(h).d1); \
+        su2vec_sub_single((r).d4,(h).d2);}
+
+/* r+=(1-gamma_1)*w, given its upper half h (proj_m1) */
+#define su2wferm_recon_add_m1(r,h){ \
+        su2vec_add_single((r).d1,(h).d1); \
+        su2vec_add_single((r).d2,(h).d2); \
+        su2vec_sub_i_single((r).d3,(h).d2); \
+        su2vec_sub_i_single((r).d4,(h).d1);}
+
+/* r+=(1+gamma_1)*w, given its upper half h (proj_p1) */
+#define su2wferm_recon_add_p1(r,h){ \
+        su2vec_add_single((r).d1,(h).d1); \
+        su2vec_add_single((r).d2,(h).d2); \
+        su2vec_add_i_single((r).d3,(h).d2); \
+        su2vec_add_i_single((r).d4,(h).d1);}
+
+/* r+=(1-gamma_2)*w, given its upper half h (proj_m2) */
+#define su2wferm_recon_add_m2(r,h){ \
+        su2vec_add_single((r).d1,(h).d1); \
+        su2vec_add_single((r).d2,(h).d2); \
+        su2vec_sub_single((r).d3,(h).d2); \
+        su2vec_add_single((r).d4,(h).d1);}
+
+/* r+=(1+gamma_2)*w, given its upper half h (proj_p2) */
+#define su2wferm_recon_add_p2(r,h){ \
+        su2vec_add_single((r).d1,(h).d1); \
+        su2vec_add_single((r).d2,(h).d2); \
+        su2vec_add_single((r).d3,(h).d2); \
+        su2vec_sub_single((r).d4,(h).d1);}
+
+/* r+=(1-gamma_3)*w, given its upper half h (proj_m3) */
+#define su2wferm_recon_add_m3(r,h){ \
+        su2vec_add_single((r).d1,(h).d1); \
+        su2vec_add_single((r).d2,(h).d2); \
+        su2vec_sub_i_single((r).d3,(h).d1); \
+        su2vec_add_i_single((r).d4,(h).d2);}
+
+/* r+=(1+gamma_3)*w, given its upper half h (proj_p3) */
+#define su2wferm_recon_add_p3(r,h){ \
+        su2vec_add_single((r).d1,(h).d1); \
+        su2vec_add_single((r).d2,(h).d2); \
+        su2vec_add_i_single((r).d3,(h).d1); \
+        su2vec_sub_i_single((r).d4,(h).d2);}
+
+/* r-=(1-gamma_0)*w, given its upper half h (proj_m0) */
+#define su2wferm_recon_sub_m0(r,h){ \
+        su2vec_sub_single((r).d1,(h).d1); \
+        su2vec_sub_single((r).d2,(h).d2); \
+        su2vec_sub_single((r).d3,(h).d1); \
+        su2vec_sub_single((r).d4,(h).d2);}
+
+/* r-=(1+gamma_0)*w, given its upper half h (proj_p0) */
+#define su2wferm_recon_sub_p0(r,h){ \
+        su2vec_sub_single((r).d1,(h).d1); \
+        su2vec_sub_single((r).d2,(h).d2); \
+        su2vec_add_single((r).d3,(h).d1); \
+        su2vec_add_single((r).d4,(h).d2);}
+
+/* v=u*w (u: SU(2) matrix; w: half fermion) */
+#define su2hferm_su2_mult(v,u,w){ \
+        su2vec_su2_mult((v).d1,u,(w).d1); \
+        su2vec_su2_mult((v).d2,u,(w).d2);}
+
+/* v=u^+*w (u: SU(2) matrix; w: half fermion) */
+#define su2hferm_su2_dag_mult(v,u,w){ \
+        su2vec_su2_dag_mult((v).d1,u,(w).d1); \
+        su2vec_su2_dag_mult((v).d2,u,(w).d2);}
+
 
 
 /* SU(3) vector macros */
@@ -300,6 +479,42 @@ typedef struct
         (r).c3.re=(c)*(s).c3.re; \
         (r).c3.im=(c)*(s).c3.im;}
 
+/* r=s1+i*s2 */
+#define su3vec_add_i(r,s1,s2){ \
+        (r).c1.re=(s1).c1.re-(s2).c1.im; \
+        (r).c1.im=(s1).c1.im+(s2).c1.re; \
+        (r).c2.re=(s1).c2.re-(s2).c2.im; \
+        (r).c2.im=(s1).c2.im+(s2).c2.re; \
+        (r).c3.re=(s1).c3.re-(s2).c3.im; \
+        (r).c3.im=(s1).c3.im+(s2).c3.re;}
+
+/* r+=i*s */
+#define su3vec_add_i_single(r,s){ \
+        (r).c1.re-=(s).c1.im; \
+        (r).c1.im+=(s).c1.re; \
+        (r).c2.re-=(s).c2.im; \
+        (r).c2.im+=(s).c2.re; \
+        (r).c3.re-=(s).c3.im; \
+        (r).c3.im+=(s).c3.re;}
+
+/* r=s1-i*s2 */
+#define su3vec_sub_i(r,s1,s2){ \
+        (r).c1.re=(s1).c1.re+(s2).c1.im; \
+        (r).c1.im=(s1).c1.im-(s2).c1.re; \
+        (r).c2.re=(s1).c2.re+(s2).c2.im; \
+        (r).c2.im=(s1).c2.im-(s2).c2.re; \
+        (r).c3.re=(s1).c3.re+(s2).c3.im; \
+        (r).c3.im=(s1).c3.im-(s2).c3.re;}
+
+/* r-=i*s */
+#define su3vec_sub_i_single(r,s){ \
+        (r).c1.re+=(s).c1.im; \
+        (r).c1.im-=(s).c1.re; \
+        (r).c2.re+=(s).c2.im; \
+        (r).c2.im-=(s).c2.re; \
+        (r).c3.re+=(s).c3.im; \
+        (r).c3.im-=(s).c3.re;}
+
 /* r=u*s (u: SU(3) matrix; s: SU(3) vector) */
 #define su3vec_su3_mult(r,u,s){ \
         (r).c1.re= (u).c11.re*(s).c1.re-(u).c11.im*(s).c1.im  \
@@ -458,3 +673,150 @@ typedef struct
         su3vec_su3_dag_mult((v).d3,u,(w).d3); \
         su3vec_su3_dag_mult((v).d4,u,(w).d4);}
 
+/* r=0 */
+#define su3wferm_zero(r){ \
+        (r).d1.c1.re=0.0; \
+        (r).d1.c1.im=0.0; \
+        (r).d1.c2.re=0.0; \
+        (r).d1.c2.im=0.0; \
+        (r).d1.c3.re=0.0; \
+        (r).d1.c3.im=0.0; \
+        (r).d2.c1.re=0.0; \
+        (r).d2.c1.im=0.0; \
+        (r).d2.c2.re=0.0; \
+        (r).d2.c2.im=0.0; \
+        (r).d2.c3.re=0.0; \
+        (r).d2.c3.im=0.0; \
+        (r).d3.c1.re=0.0; \
+        (r).d3.c1.im=0.0; \
+        (r).d3.c2.re=0.0; \
+        (r).d3.c2.im=0.0; \
+        (r).d3.c3.re=0.0; \
+        (r).d3.c3.im=0.0; \
+        (r).d4.c1.re=0.0; \
+        (r).d4.c1.im=0.0; \
+        (r).d4.c2.re=0.0; \
+        (r).d4.c2.im=0.0; \
+        (r).d4.c3.re=0.0; \
+        (r).d4.c3.im=0.0;}
+
+/* h=upper half of (1-gamma_0)*w */
+#define su3wferm_proj_m0(h,w){ \
+        su3vec_add((h).d1,(w).d1,(w).d3); \
+        su3vec_add((h).d2,(w).d2,(w).d4);}
+
+/* h=upper half of (1+gamma_0)*w */
+#define su3wferm_proj_p0(h,w){ \
+        su3vec_sub((h).d1,(w).d1,(w).d3); \
+        su3vec_sub((h).d2,(w).d2,(w).d4);}
+
+/* h=upper half of (1-gamma_1)*w */
+#define su3wferm_proj_m1(h,w){ \
+        su3vec_add_i((h).d1,(w).d1,(w).d4); \
+        su3vec_add_i((h).d2,(w).d2,(w).d3);}
+
+/* h=upper half of (1+gamma_1)*w */
+#define su3wferm_proj_p1(h,w){ \
+        su3vec_sub_i((h).d1,(w).d1,(w).d4); \
+        su3vec_sub_i((h).d2,(w).d2,(w).d3);}
+
+/* h=upper half of (1-gamma_2)*w */
+#define su3wferm_proj_m2(h,w){ \
+        su3vec_add((h).d1,(w).d1,(w).d4); \
+        su3vec_sub((h).d2,(w).d2,(w).d3);}
+
+/* h=upper half of (1+gamma_2)*w */
+#define su3wferm_proj_p2(h,w){ \
+        su3vec_sub((h).d1,(w).d1,(w).d4); \
+        su3vec_add((h).d2,(w).d2,(w).d3);}
+
+/* h=upper half of (1-gamma_3)*w */
+#define su3wferm_proj_m3(h,w){ \
+        su3vec_add_i((h).d1,(w).d1,(w).d3); \
+        su3vec_sub_i((h).d2,(w).d2,(w).d4);}
+
+/* h=upper half of (1+gamma_3)*w */
+#define su3wferm_proj_p3(h,w){ \
+        su3vec_sub_i((h).d1,(w).d1,(w).d3); \
+        su3vec_add_i((h).d2,(w).d2,(w).d4);}
+
+/* r+=(1-gamma_0)*w, given its upper half h (proj_m0) */
+#define su3wferm_recon_add_m0(r,h){ \
+        su3vec_add_single((r).d1,(h).d1); \
+        su3vec_add_single((r).d2,(h).d2); \
+        su3vec_add_single((r).d3,(h).d1); \
+        su3vec_add_single((r).d4,(h).d2);}
+
+/* r+=(1+gamma_0)*w, given its upper half h (proj_p0) */
+#define su3wferm_recon_add_p0(r,h){ \
+        su3vec_add_single((r).d1,(h).d1); \
+        su3vec_add_single((r).d2,(h).d2); \
+        su3vec_sub_single((r).d3,(h).d1); \
+        su3vec_sub_single((r).d4,(h).d2);}
+
+/* r+=(1-gamma_1)*w, given its upper half h (proj_m1) */
+#define su3wferm_recon_add_m1(r,h){ \
+        su3vec_add_single((r).d1,(h).d1); \
+        su3vec_add_single((r).d2,(h).d2); \
+        su3vec_sub_i_single((r).d3,(h).d2); \
+        su3vec_sub_i_single((r).d4,(h).d1);}
+
+/* r+=(1+gamma_1)*w, given its upper half h (proj_p1) */
+#define su3wferm_recon_add_p1(r,h){ \
+        su3vec_add_single((r).d1,(h).d1); \
+        su3vec_add_single((r).d2,(h).d2); \
+        su3vec_add_i_single((r).d3,(h).d2); \
+        su3vec_add_i_single((r).d4,(h).d1);}
+
+/* r+=(1-gamma_2)*w, given its upper half h (proj_m2) */
+#define su3wferm_recon_add_m2(r,h){ \
+        su3vec_add_single((r).d1,(h).d1); \
+        su3vec_add_single((r).d2,(h).d2); \
+        su3vec_sub_single((r).d3,(h).d2); \
+        su3vec_add_single((r).d4,(h).d1);}
+
+/* r+=(1+gamma_2)*w, given its upper half h (proj_p2) */
+#define su3wferm_recon_add_p2(r,h){ \
+        su3vec_add_single((r).d1,(h).d1); \
+        su3vec_add_single((r).d2,(h).d2); \
+        su3vec_add_single((r).d3,(h).d2); \
+        su3vec_sub_single((r).d4,(h).d1);}
+
+/* r+=(1-gamma_3)*w, given its upper half h (proj_m3) */
+#define su3wferm_recon_add_m3(r,h){ \
+        su3vec_add_single((r).d1,(h).d1); \
+        su3vec_add_single((r).d2,(h).d2); \
+        su3vec_sub_i_single((r).d3,(h).d1); \
+        su3vec_add_i_single((r).d4,(h).d2);}
+
+/* r+=(1+gamma_3)*w, given its upper half h (proj_p3) */
+#define su3wferm_recon_add_p3(r,h){ \
+        su3vec_add_single((r).d1,(h).d1); \
+        su3vec_add_single((r).d2,(h).d2); \
+        su3vec_add_i_single((r).d3,(h).d1); \
+        su3vec_sub_i_single((r).d4,(h).d2);}
+
+/* r-=(1-gamma_0)*w, given its upper half h (proj_m0) */
+#define su3wferm_recon_sub_m0(r,h){ \
+        su3vec_sub_single((r).d1,(h).d1); \
+        su3vec_sub_single((r).d2,(h).d2); \
+        su3vec_sub_single((r).d3,(h).d1); \
+        su3vec_sub_single((r).d4,(h).d2);}
+
+/* r-=(1+gamma_0)*w, given its upper half h (proj_p0) */
+#define su3wferm_recon_sub_p0(r,h){ \
+        su3vec_sub_single((r).d1,(h).d1); \
+        su3vec_sub_single((r).d2,(h).d2); \
+        su3vec_add_single((r).d3,(h).d1); \
+        su3vec_add_single((r).d4,(h).d2);}
+
+/* v=u*w (u: SU(3) matrix; w: half fermion) */
+#define su3hferm_su3_mult(v,u,w){ \
+        su3vec_su3_mult((v).d1,u,(w).d1); \
+        su3vec_su3_mult((v).d2,u,(w).d2);}
+
+/* v=u^+*w (u: SU(3) matrix; w: half fermion) */
+#define su3hferm_su3_dag_mult(v,u,w){ \
+        su3vec_su3_dag_mult((v).d1,u,(w).d1); \
+        su3vec_su3_dag_mult((v).d2,u,(w).d2);}
+
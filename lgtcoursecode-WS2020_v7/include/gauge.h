@@ -182,6 +182,11 @@ typedef struct
         (tr).re=2.*(u).c0; \
         (tr).im=0.;}
 
+/* tr=Re(Tr(v*w)) : tr real */
+#define su2_trace_mul(tr,v,w){ \
+        (tr)=2.*((v).c0*(w).c0-(v).c1*(w).c1 \
+                -(v).c2*(w).c2-(v).c3*(w).c3);}
+
 /* a=u : a complex 2x2 array */
 #define mksu2_2x2(a,u){ \
         ((a)[0][0]).re=(u).c0; \
@@ -633,6 +638,18 @@ typedef struct
         (tr).re=(u).c11.re+(u).c22.re+(u).c33.re; \
         (tr).im=(u).c11.im+(u).c22.im+(u).c33.im;}
 
+/* tr=Re(Tr(v*w)) : tr real */
+#define su3_trace_mul_re(tr,v,w){ \
+        (tr)= (v).c11.re*(w).c11.re-(v).c11.im*(w).c11.im  \
+             +(v).c12.re*(w).c21.re-(v).c12.im*(w).c21.im  \
+             +(v).c13.re*(w).c31.re-(v).c13.im*(w).c31.im  \
+             +(v).c21.re*(w).c12.re-(v).c21.im*(w).c12.im  \
+             +(v).c22.re*(w).c22.re-(v).c22.im*(w).c22.im  \
+             +(v).c23.re*(w).c32.re-(v).c23.im*(w).c32.im  \
+             +(v).c31.re*(w).c13.re-(v).c31.im*(w).c13.im  \
+             +(v).c32.re*(w).c23.re-(v).c32.im*(w).c23.im  \
+             +(v).c33.re*(w).c33.re-(v).c33.im*(w).c33.im;}
+
 /* a=u : a complex 3x3 matrix */
 #define mksu3_3x3(a,u){ \
         (a)[0][0]=(u).c11; \
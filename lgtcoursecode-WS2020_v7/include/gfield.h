@@ -0,0 +1,303 @@
+/*******************************************************************************
+*
+* File gfield.h
+*
+* This software is distributed under the terms of the GNU General Public
+* License (GPL)
+*
+* Includes the storage layout of the gauge fields and the macros to access
+* single links. A gauge field is a flat, aligned array of doubles holding
+* the NLINK=VOL_GF*DIM links. The link in direction dir starting at point n
+* has the link index l=n*DIM+dir and its SUNVOL real components are stored
+* at f[gf_offset(l)+c*GF_STRIDE], c=0,..,SUNVOL-1. The layout is chosen at
+* compile time via GAUGE_LAYOUT (see headers.h):
+*
+* GAUGE_LAYOUT==0 : array of structures, the components of a link are
+*                   contiguous and the DIM links of a point follow each other.
+* GAUGE_LAYOUT==1 : structure of arrays, component c of all links is stored
+*                   in one contiguous array of length NLINK.
+* GAUGE_LAYOUT==2 : array of structures of arrays, blocks of SIMD_WIDTH
+*                   consecutive links store each component contiguously.
+*
+* For SU(3) the links can be stored in compressed form, chosen at compile
+* time via GAUGE_COMPRESS (see headers.h). Then only GF_NREAL<SUNVOL reals
+* are stored per link and the full matrix is reconstructed in gf_get:
+*
+* GAUGE_COMPRESS==0 : all SUNVOL reals are stored.
+* GAUGE_COMPRESS==1 : the first two rows (12 reals) are stored, the third
+*                     row is rebuilt as the complex conjugate of their
+*                     cross product.
+* GAUGE_COMPRESS==2 : 8 reals are stored, U12, U13, U21 and the phases of
+*                     U11 and U31. The moduli of U11 and U31 follow from the
+*                     normalisation of the first row and column, the
+*                     remaining entries from the orthogonality of the rows.
+*                     The latter divide by |U12|^2+|U13|^2, so links with
+*                     |U12|^2+|U13|^2<GF_NRM8 (e.g. links close to diagonal
+*                     matrices) are stored with the smaller one of U22 and
+*                     U23 in place of U21 and the phase of the larger one in
+*                     place of the one of U31, shifted by GF_FLAG8 (U22) or
+*                     2*GF_FLAG8 (U23) as a flag. The modulus of the larger
+*                     one and U21 then follow from the normalisation and
+*                     the orthogonality of the first two rows.
+*
+* The compressed forms assume exact SU(3) matrices. The reconstruction is
+* accurate to rounding errors, except for the 8 reals form where the
+* precision of U11 and U31 degrades if |U11| or |U31| is very small, since
+* their moduli are obtained as square roots of differences of the
+* normalisation.
+*
+* All kernels load links into local sun_mat variables via gf_get and store
+* them back via gf_set, so that they do not depend on the layout.
+*
+*******************************************************************************/
+
+#define GFIELD_H
+
+#include <stddef.h>
+
+#define NLINK ((size_t)(VOL_GF) * DIM)
+#define GF_ALIGN 64
+
+/* number of reals stored per link */
+#if (GAUGE_COMPRESS == 0)
+#define GF_NREAL SUNVOL
+#elif (GAUGE_COMPRESS == 1)
+#define GF_NREAL 12
+#elif (GAUGE_COMPRESS == 2)
+#define GF_NREAL 8
+#endif
+
+#if (GAUGE_LAYOUT == 0)
+#define GF_SIZE (NLINK * GF_NREAL)
+#define GF_STRIDE 1
+#define gf_offset(l) ((size_t)(l) * GF_NREAL)
+#elif (GAUGE_LAYOUT == 1)
+#define GF_SIZE (NLINK * GF_NREAL)
+#define GF_STRIDE NLINK
+#define gf_offset(l) ((size_t)(l))
+#elif (GAUGE_LAYOUT == 2)
+#define GF_SIZE (((NLINK + SIMD_WIDTH - 1) / SIMD_WIDTH) * SIMD_WIDTH * GF_NREAL)
+#define GF_STRIDE SIMD_WIDTH
+#define gf_offset(l) (((size_t)(l) / SIMD_WIDTH) * SIMD_WIDTH * GF_NREAL + (size_t)(l) % SIMD_WIDTH)
+#endif
+
+/* l=index of the link U_dir(n) */
+#define gf_link(n,dir) ((size_t)(n) * DIM + (size_t)(dir))
+
+#if (GAUGE_COMPRESS == 0)
+
+/* u=U_dir(n) of the gauge field f */
+#define gf_get(u,f,n,dir){ \
+        double *gf_d=(double*)(&(u)); \
+        const double *gf_s=(f)+gf_offset(gf_link(n,dir)); \
+        int gf_c; \
+        for(gf_c=0;gf_c<SUNVOL;gf_c++) \
+           gf_d[gf_c]=gf_s[(size_t)gf_c*GF_STRIDE];}
+
+/* U_dir(n) of the gauge field f =u */
+#define gf_set(f,n,dir,u){ \
+        const double *gf_s=(const double*)(&(u)); \
+        double *gf_d=(f)+gf_offset(gf_link(n,dir)); \
+        int gf_c; \
+        for(gf_c=0;gf_c<SUNVOL;gf_c++) \
+           gf_d[(size_t)gf_c*GF_STRIDE]=gf_s[gf_c];}
+
+#else
+
+#include <math.h>
+
+#define GF_FLAG8 10.0
+#define GF_NRM8 0.5
+
+/* r[0..GF_NREAL-1]=compressed form of the SU(3) matrix u */
+static inline void gf_pack(double *r, const su3mat *u)
+{
+#if (GAUGE_COMPRESS == 1)
+   const double *d=(const double*)(u);
+   int c;
+
+   for(c=0;c<12;c++)
+      r[c]=d[c];
+#elif (GAUGE_COMPRESS == 2)
+   double nrm;
+
+   nrm=(*u).c12.re*(*u).c12.re+(*u).c12.im*(*u).c12.im
+      +(*u).c13.re*(*u).c13.re+(*u).c13.im*(*u).c13.im;
+
+   r[0]=(*u).c12.re;
+   r[1]=(*u).c12.im;
+   r[2]=(*u).c13.re;
+   r[3]=(*u).c13.im;
+   r[6]=atan2((*u).c11.im,(*u).c11.re);
+
+   if(nrm>=GF_NRM8)
+   {
+      r[4]=(*u).c21.re;
+      r[5]=(*u).c21.im;
+      r[7]=atan2((*u).c31.im,(*u).c31.re);
+   }
+   else if(((*u).c22.re*(*u).c22.re+(*u).c22.im*(*u).c22.im)
+           >=((*u).c23.re*(*u).c23.re+(*u).c23.im*(*u).c23.im))
+   {
+      r[4]=(*u).c23.re;
+      r[5]=(*u).c23.im;
+      r[7]=atan2((*u).c22.im,(*u).c22.re)+GF_FLAG8;
+   }
+   else
+   {
+      r[4]=(*u).c22.re;
+      r[5]=(*u).c22.im;
+      r[7]=atan2((*u).c23.im,(*u).c23.re)+2.*GF_FLAG8;
+   }
+#endif
+}
+
+/* u=SU(3) matrix reconstructed from its compressed form r[0..GF_NREAL-1] */
+static inline void gf_unpack(su3mat *u, const double *r)
+{
+#if (GAUGE_COMPRESS == 1)
+   double *d=(double*)(u);
+   int c;
+
+   for(c=0;c<12;c++)
+      d[c]=r[c];
+#elif (GAUGE_COMPRESS == 2)
+   double nrm,m1,m3,ni,a,b,c,ph;
+   complex a1b1,a1c1,u1b,u1s,ca,cb,*big,*sml;
+
+   if(r[7]<0.5*GF_FLAG8)
+   {
+      (*u).c12.re=r[0];
+      (*u).c12.im=r[1];
+      (*u).c13.re=r[2];
+      (*u).c13.im=r[3];
+      (*u).c21.re=r[4];
+      (*u).c21.im=r[5];
+
+      nrm=r[0]*r[0]+r[1]*r[1]+r[2]*r[2]+r[3]*r[3];
+      m1=sqrt(fabs(1.-nrm));
+      m3=sqrt(fabs(nrm-r[4]*r[4]-r[5]*r[5]));
+      (*u).c11.re=m1*cos(r[6]);
+      (*u).c11.im=m1*sin(r[6]);
+      (*u).c31.re=m3*cos(r[7]);
+      (*u).c31.im=m3*sin(r[7]);
+
+      /* a1b1=U11^* U21, a1c1=U11^* U31 */
+      a1b1.re=(*u).c11.re*(*u).c21.re+(*u).c11.im*(*u).c21.im;
+      a1b1.im=(*u).c11.re*(*u).c21.im-(*u).c11.im*(*u).c21.re;
+      a1c1.re=(*u).c11.re*(*u).c31.re+(*u).c11.im*(*u).c31.im;
+      a1c1.im=(*u).c11.re*(*u).c31.im-(*u).c11.im*(*u).c31.re;
+      ni=1./nrm;
+
+      /* U22=-(U11^* U21 U12+U13^* U31^*)/nrm */
+      (*u).c22.re=-ni*(a1b1.re*(*u).c12.re-a1b1.im*(*u).c12.im
+                       +(*u).c13.re*(*u).c31.re-(*u).c13.im*(*u).c31.im);
+      (*u).c22.im=-ni*(a1b1.re*(*u).c12.im+a1b1.im*(*u).c12.re
+                       -(*u).c13.re*(*u).c31.im-(*u).c13.im*(*u).c31.re);
+      /* U23=(U12^* U31^*-U11^* U21 U13)/nrm */
+      (*u).c23.re=ni*((*u).c12.re*(*u).c31.re-(*u).c12.im*(*u).c31.im
+                      -a1b1.re*(*u).c13.re+a1b1.im*(*u).c13.im);
+      (*u).c23.im=ni*(-(*u).c12.re*(*u).c31.im-(*u).c12.im*(*u).c31.re
+                      -a1b1.re*(*u).c13.im-a1b1.im*(*u).c13.re);
+      /* U32=(U13^* U21^*-U11^* U31 U12)/nrm */
+      (*u).c32.re=ni*((*u).c13.re*(*u).c21.re-(*u).c13.im*(*u).c21.im
+                      -a1c1.re*(*u).c12.re+a1c1.im*(*u).c12.im);
+      (*u).c32.im=ni*(-(*u).c13.re*(*u).c21.im-(*u).c13.im*(*u).c21.re
+                      -a1c1.re*(*u).c12.im-a1c1.im*(*u).c12.re);
+      /* U33=-(U12^* U21^*+U11^* U31 U13)/nrm */
+      (*u).c33.re=-ni*((*u).c12.re*(*u).c21.re-(*u).c12.im*(*u).c21.im
+                       +a1c1.re*(*u).c13.re-a1c1.im*(*u).c13.im);
+      (*u).c33.im=-ni*(-(*u).c12.re*(*u).c21.im-(*u).c12.im*(*u).c21.re
+                       +a1c1.re*(*u).c13.im+a1c1.im*(*u).c13.re);
+      return;
+   }
+
+   /* |U12|^2+|U13|^2<GF_NRM8: row 2 is (U21,big,sml), where sml is the
+    * stored one of U22 and U23 and big=m*exp(i*ph) the other one, u1b and
+    * u1s are the entries of row 1 in their columns */
+   (*u).c12.re=r[0];
+   (*u).c12.im=r[1];
+   (*u).c13.re=r[2];
+   (*u).c13.im=r[3];
+   nrm=r[0]*r[0]+r[1]*r[1]+r[2]*r[2]+r[3]*r[3];
+   m1=sqrt(1.-nrm);
+   (*u).c11.re=m1*cos(r[6]);
+   (*u).c11.im=m1*sin(r[6]);
+
+   if(r[7]<1.5*GF_FLAG8)
+   {
+      ph=r[7]-GF_FLAG8;
+      big=&((*u).c22);
+      sml=&((*u).c23);
+      u1b=(*u).c12;
+      u1s=(*u).c13;
+   }
+   else
+   {
+      ph=r[7]-2.*GF_FLAG8;
+      big=&((*u).c23);
+      sml=&((*u).c22);
+      u1b=(*u).c13;
+      u1s=(*u).c12;
+   }
+   (*sml).re=r[4];
+   (*sml).im=r[5];
+
+   /* orthogonality of the rows: U21^*=m*ca+cb with
+    * ca=-u1b*exp(-i*ph)/U11, cb=-u1s*conj(sml)/U11 */
+   ni=1./(m1*m1);
+   ca.re=-ni*((*u).c11.re*(u1b.re*cos(ph)+u1b.im*sin(ph))
+              +(*u).c11.im*(u1b.im*cos(ph)-u1b.re*sin(ph)));
+   ca.im=-ni*((*u).c11.re*(u1b.im*cos(ph)-u1b.re*sin(ph))
+              -(*u).c11.im*(u1b.re*cos(ph)+u1b.im*sin(ph)));
+   cb.re=-ni*((*u).c11.re*(u1s.re*(*sml).re+u1s.im*(*sml).im)
+              +(*u).c11.im*(u1s.im*(*sml).re-u1s.re*(*sml).im));
+   cb.im=-ni*((*u).c11.re*(u1s.im*(*sml).re-u1s.re*(*sml).im)
+              -(*u).c11.im*(u1s.re*(*sml).re+u1s.im*(*sml).im));
+
+   /* normalisation of row 2: a*m^2+2*b*m+c=0, c<0 */
+   a=1.+ca.re*ca.re+ca.im*ca.im;
+   b=ca.re*cb.re+ca.im*cb.im;
+   c=cb.re*cb.re+cb.im*cb.im+(*sml).re*(*sml).re+(*sml).im*(*sml).im-1.;
+   m3=(sqrt(fabs(b*b-a*c))-b)/a;
+
+   (*big).re=m3*cos(ph);
+   (*big).im=m3*sin(ph);
+   (*u).c21.re=m3*ca.re+cb.re;
+   (*u).c21.im=-(m3*ca.im+cb.im);
+#endif
+   /* row 3=(row 1 x row 2)^*, written on the entries of u since accesses
+    * through su3vec casts of its rows violate strict aliasing */
+   (*u).c31.re= (*u).c12.re*(*u).c23.re-(*u).c12.im*(*u).c23.im
+               -(*u).c13.re*(*u).c22.re+(*u).c13.im*(*u).c22.im;
+   (*u).c31.im= (*u).c13.re*(*u).c22.im+(*u).c13.im*(*u).c22.re
+               -(*u).c12.re*(*u).c23.im-(*u).c12.im*(*u).c23.re;
+   (*u).c32.re= (*u).c13.re*(*u).c21.re-(*u).c13.im*(*u).c21.im
+               -(*u).c11.re*(*u).c23.re+(*u).c11.im*(*u).c23.im;
+   (*u).c32.im= (*u).c11.re*(*u).c23.im+(*u).c11.im*(*u).c23.re
+               -(*u).c13.re*(*u).c21.im-(*u).c13.im*(*u).c21.re;
+   (*u).c33.re= (*u).c11.re*(*u).c22.re-(*u).c11.im*(*u).c22.im
+               -(*u).c12.re*(*u).c21.re+(*u).c12.im*(*u).c21.im;
+   (*u).c33.im= (*u).c12.re*(*u).c21.im+(*u).c12.im*(*u).c21.re
+               -(*u).c11.re*(*u).c22.im-(*u).c11.im*(*u).c22.re;
+}
+
+/* u=U_dir(n) of the gauge field f */
+#define gf_get(u,f,n,dir){ \
+        double gf_r[GF_NREAL]; \
+        const double *gf_s=(f)+gf_offset(gf_link(n,dir)); \
+        int gf_c; \
+        for(gf_c=0;gf_c<GF_NREAL;gf_c++) \
+           gf_r[gf_c]=gf_s[(size_t)gf_c*GF_STRIDE]; \
+        gf_unpack(&(u),gf_r);}
+
+/* U_dir(n) of the gauge field f =u */
+#define gf_set(f,n,dir,u){ \
+        double gf_r[GF_NREAL]; \
+        double *gf_d=(f)+gf_offset(gf_link(n,dir)); \
+        int gf_c; \
+        gf_pack(gf_r,&(u)); \
+        for(gf_c=0;gf_c<GF_NREAL;gf_c++) \
+           gf_d[(size_t)gf_c*GF_STRIDE]=gf_r[gf_c];}
+
+#endif
@@ -16,12 +16,17 @@
 #define HEADERS_H
 
 #define DIM 4
+#ifndef SUN
 #define SUN 2
+#endif
 
+/* the extents can be overridden from the Makefile, e.g. for benchmarks */
+#ifndef LENGT
 #define LENGT 64
 #define LENGS1 64
 #define LENGS2 64
 #define LENGS3 64
+#endif
 
 #define NAME_SIZE 128
 /* base and dir will be NAME_SIZE long, plus '/' and 4 chars for '.ext' */
@@ -30,13 +35,107 @@
 
 /* SIM_TYPE==0 : Metropolis */
 /* SIM_TYPE==1 : Heatbath */
+/* SIM_TYPE==2 : Heatbath followed by nover overrelaxation sweeps (see input file) */
 #define SIM_TYPE 1
 
+/* SWEEP_TYPE==0 : sequential sweeps */
 /* SWEEP_TYPE==1 : random sweeps */
+/* SWEEP_TYPE==2 : checkerboard sweeps, parallelised with OpenMP */
+#ifndef SWEEP_TYPE
 #define SWEEP_TYPE 0
+#endif
+
+/* RNG_TYPE == 0 : random numbers from ranlxd, one generator per OpenMP thread (see init.c) */
+/* RNG_TYPE == 1 : counter-based random numbers (Philox), one stream per link update (see philox.c) */
+#ifndef RNG_TYPE
+#define RNG_TYPE 1
+#endif
+
+/* Number of random number streams a thread can draw from at the same time
+ * (see philox.c). The heatbath updates batches of RANDOM_SLOTS links */
+#ifndef RANDOM_SLOTS
+#define RANDOM_SLOTS 16
+#endif
+
+/* Number of sweeps after which the summed plaquette, which gaugefieldUpdate
+ * keeps track of via the changes of the local updates (see update.c), is
+ * recomputed from the links */
+#ifndef PLAQ_RESYNC
+#define PLAQ_RESYNC 100
+#endif
+
+/* SOLVER_TYPE==0 : CG on the normal equations of the full Dirac operator */
+/* SOLVER_TYPE==1 : even-odd preconditioned CG (Schur complement on the even points) */
+/* SOLVER_TYPE==2 : even-odd preconditioned block CG for all sources at once */
+#ifndef SOLVER_TYPE
+#define SOLVER_TYPE 1
+#endif
+
+/* Number of blocks of points per OpenMP thread of the reductions over spinor
+ * fields (see spin_alg.c). The number of blocks nb=reductionBlocks() is fixed
+ * at the first reduction and the block sums are added in a fixed order, such
+ * that the results do not change if the number of threads is changed later
+ * on. Block b of nvol points starts at point red_block_start(b,nb,nvol) */
+#ifndef NRED_BLOCKS_PER_THREAD
+#define NRED_BLOCKS_PER_THREAD 4
+#endif
+#define red_block_start(b,nb,nvol) ((int)(((size_t)(b) * (size_t)(nvol)) / (size_t)(nb)))
 
 /* MASTER_FIELD == 1 : simulation on a master-field. Will be constructed from a number of sublattices specified above */
+#ifndef MASTER_FIELD
 #define MASTER_FIELD 1
+#endif
+
+/* MF_FILE_LAYOUT == 0 : master-field files in lexicographic order of the master field */
+/* MF_FILE_LAYOUT == 1 : master-field files stored sublattice by sublattice (see config_IO.c) */
+#ifndef MF_FILE_LAYOUT
+#define MF_FILE_LAYOUT 0
+#endif
+
+/* MF_IO_MMAP == 1 : master-field files are accessed through a memory mapping (see config_IO.c) */
+#ifndef MF_IO_MMAP
+#define MF_IO_MMAP 0
+#endif
+
+/* MF_HALO_CACHE : number of recently written sublattices whose boundary links are kept in memory, */
+/*                 outer layers found there are not read from the master-field file (see config_IO.c) */
+#ifndef MF_HALO_CACHE
+#define MF_HALO_CACHE 0
+#endif
+
+/* MF_PIPELINE == 1 : master-field sweeps read and write the sublattices in a separate I/O thread (see mf_pipeline.c) */
+#ifndef MF_PIPELINE
+#define MF_PIPELINE 0
+#endif
+
+/* MF_COLOUR == 1 : master-field sweeps update the sublattices of each of the 2^DIM colours concurrently */
+/*                  on the OpenMP threads (see mf_colour.c), takes precedence over MF_PIPELINE */
+#ifndef MF_COLOUR
+#define MF_COLOUR 0
+#endif
+
+/* MPI_PARALLEL == 1 : the master field is distributed over MPI processes, one sublattice per process, */
+/*                     requires checkerboard sweeps (see mpi_comm.c and main_mpi) */
+#ifndef MPI_PARALLEL
+#define MPI_PARALLEL 0
+#endif
+
+/* Storage layout of the gauge fields (see gfield.h) */
+/* GAUGE_LAYOUT==0 : array of structures (links of a point contiguous) */
+/* GAUGE_LAYOUT==1 : structure of arrays (one array per real link component) */
+/* GAUGE_LAYOUT==2 : array of structures of arrays (blocks of SIMD_WIDTH links) */
+#ifndef GAUGE_LAYOUT
+#define GAUGE_LAYOUT 0
+#endif
+#define SIMD_WIDTH 4
+
+/* Compressed storage of the SU(3) links (see gfield.h) */
+/* GAUGE_COMPRESS==0 : full matrices (SUNVOL reals) */
+/* GAUGE_COMPRESS==1 : first two rows (12 reals) */
+/* GAUGE_COMPRESS==2 : 8 reals */
+#ifndef GAUGE_COMPRESS
+#define GAUGE_COMPRESS 0
+#endif
 
 /******************************************************************************
  * Master_field setup
@@ -74,6 +173,66 @@
 #error : NAME_SIZE should be bigger or equal to 128
 #endif
 
+#if ((GAUGE_LAYOUT < 0) || (GAUGE_LAYOUT > 2))
+#error : GAUGE_LAYOUT must be set to 0, 1 or 2
+#endif
+
+#if ((SIMD_WIDTH < 1) || ((SIMD_WIDTH & (SIMD_WIDTH - 1)) != 0))
+#error : SIMD_WIDTH must be a power of 2
+#endif
+
+#if ((SOLVER_TYPE < 0) || (SOLVER_TYPE > 2))
+#error : SOLVER_TYPE must be set to 0, 1 or 2
+#endif
+
+#if (NRED_BLOCKS_PER_THREAD < 1)
+#error : NRED_BLOCKS_PER_THREAD must be at least 1
+#endif
+
+#if ((MF_FILE_LAYOUT != 0) && (MF_FILE_LAYOUT != 1))
+#error : MF_FILE_LAYOUT must be set to 0 or 1
+#endif
+
+#if ((MF_IO_MMAP != 0) && (MF_IO_MMAP != 1))
+#error : MF_IO_MMAP must be set to 0 or 1
+#endif
+
+#if (MF_HALO_CACHE < 0)
+#error : MF_HALO_CACHE must not be negative
+#endif
+
+#if ((RNG_TYPE != 0) && (RNG_TYPE != 1))
+#error : RNG_TYPE must be set to 0 or 1
+#endif
+
+#if (RANDOM_SLOTS < 1)
+#error : RANDOM_SLOTS must be positive
+#endif
+
+#if (PLAQ_RESYNC < 1)
+#error : PLAQ_RESYNC must be positive
+#endif
+
+#if ((MF_PIPELINE != 0) && (MF_PIPELINE != 1))
+#error : MF_PIPELINE must be set to 0 or 1
+#endif
+
+#if ((MF_COLOUR != 0) && (MF_COLOUR != 1))
+#error : MF_COLOUR must be set to 0 or 1
+#endif
+
+#if ((MPI_PARALLEL != 0) && (MPI_PARALLEL != 1))
+#error : MPI_PARALLEL must be set to 0 or 1
+#endif
+
+#if ((MPI_PARALLEL == 1) && ((MASTER_FIELD != 1) || (SWEEP_TYPE != 2)))
+#error : MPI_PARALLEL requires MASTER_FIELD 1 and checkerboard sweeps (SWEEP_TYPE 2)
+#endif
+
+#if ((GAUGE_COMPRESS < 0) || (GAUGE_COMPRESS > 2) || ((GAUGE_COMPRESS != 0) && (SUN != 3)))
+#error : GAUGE_COMPRESS must be set to 0, or to 1 or 2 for SU(3)
+#endif
+
 
 /******************************************************************************
  * Derived and additional definitions
@@ -82,6 +241,7 @@
 #if (DIM == 2)
 #define VOL2 ((LENGT + 2) * (LENGS1 + 2))
 #define SVOL2 ((LENGS1 + 2))
+#define LSUM2 ((LENGT + 2) + (LENGS1 + 2))
 #define VOL_MF (LENGT_MF * LENGS1_MF)
 #define SVOL_MF (LENGS1_MF)
 #define FRACT (LENGT_MF / LENGT)
@@ -90,6 +250,7 @@
 #elif (DIM == 3)
 #define VOL2 ((LENGT + 2) * (LENGS1 + 2) * (LENGS2 + 2))
 #define SVOL2 ((LENGS1 + 2) * (LENGS2 + 2))
+#define LSUM2 ((LENGT + 2) + (LENGS1 + 2) + (LENGS2 + 2))
 #define VOL_MF (LENGT_MF * LENGS1_MF * LENGS2_MF)
 #define SVOL_MF (LENGS1_MF * LENGS2_MF)
 #define FRACT (LENGT_MF / LENGT)
@@ -99,6 +260,7 @@
 #elif (DIM == 4)
 #define VOL2 ((LENGT + 2) * (LENGS1 + 2) * (LENGS2 + 2) * (LENGS3 + 2))
 #define SVOL2 ((LENGS1 + 2) * (LENGS2 + 2) * (LENGS3 + 2))
+#define LSUM2 ((LENGT + 2) + (LENGS1 + 2) + (LENGS2 + 2) + (LENGS3 + 2))
 #define VOL_MF (LENGT_MF * LENGS1_MF * LENGS2_MF * LENGS3_MF)
 #define SVOL_MF (LENGS1_MF * LENGS2_MF * LENGS3_MF)
 #define FRACT (LENGT_MF / LENGT)
@@ -123,6 +285,13 @@
 #define NPLAQ 6
 #endif
 
+/* number of points on which the gauge fields are stored */
+#if (MASTER_FIELD == 1)
+#define VOL_GF VOL2
+#else
+#define VOL_GF VOL
+#endif
+
 /******************************************************************************
  * Definition of gauge functions:
  *******************************************************************************/
@@ -151,6 +320,7 @@
 #define sun_self_sub su2_self_sub
 #define sun_trace su2_trace
 #define sun_trace_cl su2_trace_cl
+#define sun_trace_mul su2_trace_mul
 #define mksun_nxn mksu2_2x2
 #define mksun_nxn_dag mksu2_2x2_dag
 #define sun_dble_mul su2_dble_mul
@@ -180,6 +350,7 @@
 #define sun_self_sub su3_self_sub
 #define sun_trace su3_trace_re
 #define sun_trace_cl su3_trace
+#define sun_trace_mul su3_trace_mul_re
 #define mksun_nxn mksu3_3x3
 #define mksun_nxn_dag mksu3_3x3_dag
 #define sun_dble_mul su3_dble_mul
@@ -191,6 +362,11 @@
 #define set_alg_zero set_alg_zero_su3
 #endif
 
+/* Gauge field layout and link accessors */
+#ifndef GFIELD_H
+#include "gfield.h"
+#endif
+
 /* Fermion macros */
 #ifndef FERMION_H
 #include "fermion.h"
@@ -199,6 +375,7 @@
 #if (SUN == 2)
 #define sun_vec su2vec
 #define sun_wferm su2wferm
+#define sun_hferm su2hferm
 #define sun_vec_mul_i su2_vec_mul_i
 #define sun_vec_mul_mi su2_vec_mul_mi
 #define sun_vec_mul_m1 su2_vec_mul_m1
@@ -225,9 +402,35 @@
 #define mul_sunwferm_g5 mul_su2wferm_g5
 #define sunwferm_sun_mult su2wferm_su2_mult
 #define sunwferm_sun_dag_mult su2wferm_su2_dag_mult
+#define sunvec_add_i su2vec_add_i
+#define sunvec_add_i_single su2vec_add_i_single
+#define sunvec_sub_i su2vec_sub_i
+#define sunvec_sub_i_single su2vec_sub_i_single
+#define sunwferm_zero su2wferm_zero
+#define sunwferm_proj_m0 su2wferm_proj_m0
+#define sunwferm_proj_p0 su2wferm_proj_p0
+#define sunwferm_proj_m1 su2wferm_proj_m1
+#define sunwferm_proj_p1 su2wferm_proj_p1
+#define sunwferm_proj_m2 su2wferm_proj_m2
+#define sunwferm_proj_p2 su2wferm_proj_p2
+#define sunwferm_proj_m3 su2wferm_proj_m3
+#define sunwferm_proj_p3 su2wferm_proj_p3
+#define sunwferm_recon_add_m0 su2wferm_recon_add_m0
+#define sunwferm_recon_add_p0 su2wferm_recon_add_p0
+#define sunwferm_recon_add_m1 su2wferm_recon_add_m1
+#define sunwferm_recon_add_p1 su2wferm_recon_add_p1
+#define sunwferm_recon_add_m2 su2wferm_recon_add_m2
+#define sunwferm_recon_add_p2 su2wferm_recon_add_p2
+#define sunwferm_recon_add_m3 su2wferm_recon_add_m3
+#define sunwferm_recon_add_p3 su2wferm_recon_add_p3
+#define sunwferm_recon_sub_m0 su2wferm_recon_sub_m0
+#define sunwferm_recon_sub_p0 su2wferm_recon_sub_p0
+#define sunhferm_sun_mult su2hferm_su2_mult
+#define sunhferm_sun_dag_mult su2hferm_su2_dag_mult
 #elif (SUN == 3)
 #define sun_vec su3vec
 #define sun_wferm su3wferm
+#define sun_hferm su3hferm
 #define sun_vec_mul_i su3_vec_mul_i
 #define sun_vec_mul_mi su3_vec_mul_mi
 #define sun_vec_mul_m1 su3_vec_mul_m1
@@ -254,6 +457,31 @@
 #define mul_sunwferm_g5 mul_su3wferm_g5
 #define sunwferm_sun_mult su3wferm_su3_mult
 #define sunwferm_sun_dag_mult su3wferm_su3_dag_mult
+#define sunvec_add_i su3vec_add_i
+#define sunvec_add_i_single su3vec_add_i_single
+#define sunvec_sub_i su3vec_sub_i
+#define sunvec_sub_i_single su3vec_sub_i_single
+#define sunwferm_zero su3wferm_zero
+#define sunwferm_proj_m0 su3wferm_proj_m0
+#define sunwferm_proj_p0 su3wferm_proj_p0
+#define sunwferm_proj_m1 su3wferm_proj_m1
+#define sunwferm_proj_p1 su3wferm_proj_p1
+#define sunwferm_proj_m2 su3wferm_proj_m2
+#define sunwferm_proj_p2 su3wferm_proj_p2
+#define sunwferm_proj_m3 su3wferm_proj_m3
+#define sunwferm_proj_p3 su3wferm_proj_p3
+#define sunwferm_recon_add_m0 su3wferm_recon_add_m0
+#define sunwferm_recon_add_p0 su3wferm_recon_add_p0
+#define sunwferm_recon_add_m1 su3wferm_recon_add_m1
+#define sunwferm_recon_add_p1 su3wferm_recon_add_p1
+#define sunwferm_recon_add_m2 su3wferm_recon_add_m2
+#define sunwferm_recon_add_p2 su3wferm_recon_add_p2
+#define sunwferm_recon_add_m3 su3wferm_recon_add_m3
+#define sunwferm_recon_add_p3 su3wferm_recon_add_p3
+#define sunwferm_recon_sub_m0 su3wferm_recon_sub_m0
+#define sunwferm_recon_sub_p0 su3wferm_recon_sub_p0
+#define sunhferm_sun_mult su3hferm_su3_mult
+#define sunhferm_sun_dag_mult su3hferm_su3_dag_mult
 #endif
 
 /******************************************************************************
@@ -263,6 +491,7 @@
 typedef struct
 {
     int idForOutputFilesName, numConfs, numThermConfs, decorSteps, writeConfsFreq;
+    int numOverrelax, numLocalSweeps, mfShift;
     double beta, eps, mass;
     int mwil, mcorrs;
 } runParameters;
@@ -299,28 +528,27 @@ EXTERN runParameters runParams;
 EXTERN latticeParameters latParams;
 EXTERN measParameters measParams;
 
+/* the gauge field, GF_SIZE doubles in the layout defined in gfield.h. The
+ * master-field sweep of mf_colour.c passes the fields of its threads to the
+ * updates instead (see gaugefieldUpdateSublattice in update.c). */
+EXTERN double *pu;
 
-#if (MASTER_FIELD == 1)
-EXTERN sun_mat *pu[VOL2][DIM];
-
+/* the sublattice of the master field held in pu, which fixes the indices of
+ * its points on the master field (see globalIndex in init.c) */
+EXTERN int puSublattice;
 
+#if (MASTER_FIELD == 1)
 EXTERN int sl[VOL_SL];               // given an sublattice index, gives starting master-field index of given sublattice
 EXTERN int neib[VOL2][2 * DIM];      // given an normal index and direction, gives normal index in given direction (as without master-field)
-EXTERN long int index_mf[VOL2];      // given sublattice index and normal index, gives master-field index
 EXTERN int i[VOL];                   // given normal index, return index of slightly bigger lattice for input into *pu
 
-EXTERN int perm1[1][1];
-EXTERN int perm2[2][2];
-EXTERN int perm3[6][3];
-EXTERN int perm4[24][4];
-
 #elif (MASTER_FIELD == 0)
-EXTERN sun_mat *pu[VOL][DIM];
-
-
 EXTERN int neib[VOL][2 * DIM];
 #endif
 
+EXTERN int ieo[VOL];                 // indices of the even points followed by the odd points (of the sublattice)
+EXTERN int ipeo[VOL];                // given normal index, return position in the even-odd ordering
+
 EXTERN char LOG_FILE[FULL_PATH_SIZE];
 EXTERN char OUT_FILE[FULL_PATH_SIZE];
 EXTERN char CNFG_FILE[FULL_PATH_SIZE];
@@ -9,7 +9,8 @@
 * This software is distributed under the terms of the GNU General Public
 * License (GPL)
 * 
-* Contains necessary definitions for the use of the routines from endian.c.
+* Contains necessary definitions for the use of the routines from endian.c
+* and crc32c.c.
 *
 *******************************************************************************/
 
@@ -17,6 +18,7 @@
 
 #include <limits.h>
 #include <float.h>
+#include <stddef.h>
 
 #if ((DBL_MANT_DIG!=53)||(DBL_MIN_EXP!=-1021)||(DBL_MAX_EXP!=1024))
 #error : Machine is not compliant with the IEEE-754 standard
@@ -48,3 +50,7 @@ extern int endianness(void);
 extern void bswap_int(int n,stdint_t *a);
 extern void bswap_double(int n,double *a);
 #endif
+
+#ifndef CRC32C_C
+extern stduint_t crc32c(stduint_t crc,void *buf,size_t n);
+#endif
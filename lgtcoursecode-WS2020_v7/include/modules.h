@@ -29,9 +29,13 @@ extern double plaquette(void);
 extern double gaugeAction(void);
 #endif
 
+#ifndef MF_MEAS_C
+extern double measureMasterField(char*,double*,double*);
+#endif
+
 #ifndef SMEARING_C
-extern void smearing_APE_spatial(int,double,sun_mat *u[VOL][DIM]);
-extern void smearing_APE_temporal(int,double,sun_mat *u[VOL][DIM]);
+extern void smearing_APE_spatial(int,double,double*);
+extern void smearing_APE_temporal(int,double,double*);
 #endif
 
 #ifndef WILSON_C
@@ -48,6 +52,11 @@ extern void measure2ptFunctions(int*,int,int,int*,int*);
 #ifndef DIRAC_WIL_C
 extern void applyWilsonDiracOperator(sun_wferm*,sun_wferm*);
 extern void applyComplexConjDiracOperator(sun_wferm*,sun_wferm*);
+extern double applyNormalWilsonOperator(sun_wferm*,sun_wferm*,sun_wferm*);
+extern void applyHoppingTermEo(sun_wferm*,sun_wferm*,int);
+extern void applyComplexConjHoppingTermEo(sun_wferm*,sun_wferm*,int);
+extern void applyHoppingTermEoMulti(sun_wferm**,sun_wferm**,int,int);
+extern void applyComplexConjHoppingTermEoMulti(sun_wferm**,sun_wferm**,int,int);
 #endif
 
 #ifndef SPIN_ALG_C
@@ -58,6 +67,13 @@ extern double globalSquareNorm(sun_wferm*);
 extern double globalSum(sun_wferm*);
 extern double realPartOfScalarProd(sun_wferm*,sun_wferm*);
 extern complex scalarProd(sun_wferm *f2,sun_wferm *f1);
+extern void reorderSpinorsToEvenOdd(sun_wferm*,sun_wferm*);
+extern void reorderSpinorsToLexicographic(sun_wferm*,sun_wferm*);
+extern void copySpinorsHalf(sun_wferm*,sun_wferm*);
+extern void multiplyByRealHalf(sun_wferm*,double,sun_wferm*);
+extern void multiplyByRealAndSumHalf(sun_wferm*,sun_wferm*,double,sun_wferm*);
+extern double globalSquareNormHalf(sun_wferm*);
+extern double realPartOfScalarProdHalf(sun_wferm*,sun_wferm*);
 #endif
 
 #ifndef SOURCES_C
@@ -72,6 +88,13 @@ extern void deallocateFermionFieldsForCG(void);
 extern int cg(sun_wferm*,void (*A)(sun_wferm *r,sun_wferm *s),
               void (*Ad)(sun_wferm *r,sun_wferm *s),sun_wferm*,
               double,int);
+extern int cg_eo(sun_wferm*,sun_wferm*,double,int);
+#endif
+
+#ifndef SOLV_BCG_C
+extern void allocateFermionFieldsForBlockCG(int);
+extern void deallocateFermionFieldsForBlockCG(void);
+extern int bcg_eo(sun_wferm**,sun_wferm**,int,double,int,int*);
 #endif
 
 /* Updates */
@@ -81,17 +104,27 @@ extern void expx(double,sun_alg*,sun_mat*);
 #endif
 
 #ifndef METRO_C
-extern void staples(int,int,sun_mat*);
-extern double localMetropolisUpdate(int,int,int);
+extern void staples(double*,int,int,sun_mat*);
+extern double localMetropolisUpdate(double*,int,int,int,double*);
 #endif
 
 #ifndef HEATBATH_C
-/*extern void staples(int,int,sun_mat*);*/
-extern double localHeatbathUpdate(int,int,int);
+/*extern void staples(double*,int,int,sun_mat*);*/
+extern void su2HeatbathBatch(int,int*,double*,su2mat*,int*);
+extern double heatbathKernel(int,sun_mat*,sun_mat*,double);
+extern double heatbathUpdateLinks(double*,int,int*,int,double*);
+extern double localHeatbathUpdate(double*,int,int,int,double*);
+#endif
+
+#ifndef OVERRELAX_C
+extern double localOverrelaxationUpdate(double*,int,int,double*);
 #endif
 
 #ifndef UPDATE_C
 extern void gaugefieldUpdate(int,int,int,int);
+extern void gaugefieldUpdateSublattice(double*,int,int,int,int,int);
+extern double trackedPlaquette(void);
+extern void setTrackedPlaquette(double);
 #endif
 
 /* IO-archive functions */
@@ -115,6 +148,22 @@ extern void prepareConfig(char*);
 extern void writeHeaderToConfig(char*);
 extern void writeConfig(char*, int);
 extern void readConfig(char*, int);
+extern int writeConfigSublattice(char*, double*, int);
+extern int readConfigSublattice(char*, double*, int);
+extern void convertConfig(char*, char*, int);
+extern void unmapConfig(void);
+#endif
+
+#ifndef MF_COLOUR_C
+extern void initMasterFieldColouring(void);
+extern void releaseMasterFieldColouring(void);
+extern double masterFieldSweepColoured(char*, int, int);
+#endif
+
+#ifndef MF_PIPELINE_C
+extern void initMasterFieldPipeline(void);
+extern void releaseMasterFieldPipeline(void);
+extern double masterFieldSweepPipelined(char*, int, int);
 #endif
 
 /* Initialisation */
@@ -122,18 +171,26 @@ extern void readConfig(char*, int);
 #ifndef INIT_C
 extern void initProgram(int);
 extern void initArrayOfNeighbours(void);
-extern void updateArrayOfIndexMF(int);
+extern void masterFieldExtents(int*,int*);
+extern void masterFieldCoordinates(int,int*);
+extern void shiftMasterField(int);
+extern void unshiftMasterField(void);
+extern int masterFieldShifted(void);
+extern long int indexMF(int,int);
+extern long int globalIndex(int);
 extern void initArrayOfSubLattices(void);
 extern void initGlobalArrays(void);
 extern void initArrayOfBorders(int);
 extern void initArrayOfI(void);
 extern void initGaugeField(int);
 extern void releaseGaugeField(void);
-extern void allocateGaugeField(sun_mat *u[VOL][DIM]);
-extern void deallocateGaugeField(sun_mat *u[VOL][DIM]);
-extern void copyGaugeField(sun_mat *u1[VOL][DIM],sun_mat *u2[VOL][DIM]);
+extern void allocateGaugeField(double**);
+extern void deallocateGaugeField(double**);
+extern void copyGaugeField(double*,double*);
 extern void allocateFermionField(sun_wferm**);
 extern void deallocateFermionField(sun_wferm**);
+extern void initArrayOfEvenOdd(void);
+extern void initThreadRandomNumbers(int);
 #endif
 
 #ifndef RANDOM_SU3_C
@@ -145,6 +202,21 @@ extern void su3RandomMatrix(su3mat*);
 extern void su2RandomMatrix(su2mat*);
 #endif
 
+#ifndef PHILOX_C
+extern void initRandomStreams(int);
+extern void randomStream(int,long int,int);
+extern void randomNumbers(double*,int);
+extern void randomStreamSlot(int,int,long int,int);
+extern void randomNumbersSlot(int,double*,int);
+extern void randomNumbersSlots(int,int*,double*,int);
+extern void philoxWords(const unsigned int*,const unsigned int*,unsigned int*);
+extern int checkPhiloxAvx2(const unsigned int*,int,unsigned int (*)[4]);
+#endif
+
+#ifndef RNG_GAUSS_C
+extern void getManyGaussianRandomNumbers(double*,int,double);
+#endif
+
 /* utils functions */
 
 #ifndef UTILS_C
@@ -153,6 +225,8 @@ extern int custom_isnan(double);
 extern int custom_isinf(double);
 extern int fact(int);
 extern void swap(int*, int*);
+extern int reductionBlocks(void);
+extern double sumOfBlocks(double*,int);
 #endif
 
 #ifndef ERROR_CHECKS_C
@@ -160,10 +234,27 @@ extern void setWarning(void);
 extern void checkForErrors(int,int);
 #endif
 
+/* Parallelisation */
+
+#ifndef MPI_COMM_C
+extern void initMpi(int*,char***);
+extern void finalizeMpi(void);
+extern void abortMpi(int);
+extern int mpiRank(void);
+extern int mpiSize(void);
+extern void mpiBarrier(void);
+extern void initHaloExchange(void);
+extern void startHaloExchange(int);
+extern void finishHaloExchange(void);
+extern void exchangeHalo(void);
+extern double mpiGlobalSum(double);
+extern int checkerboardList(int,int**);
+#endif
+
 /* maths */
 
 #ifndef SUN_VFUNC_C
 extern void project_to_su3(su3mat *u);
 extern void project_to_su2(su2mat *u);
-extern void project_gfield_to_sun(sun_mat *u[VOL][DIM]);
+extern void project_gfield_to_sun(double*);
 #endif
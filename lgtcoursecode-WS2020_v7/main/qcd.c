@@ -33,11 +33,14 @@ int main(int argc,char *argv[])
 
    readInputFile(&seed,out_dir,&rconf,cnfg_file,argc,argv);
    rlxd_init(1,seed);
+   initRandomStreams(seed);
+   initThreadRandomNumbers(seed);
    initProgram(1);
 
    setupOutputFiles(runParams.idForOutputFilesName,out_dir);
    printStartupInfo(seed,rconf,cnfg_file);
    initArrayOfNeighbours();
+   initArrayOfEvenOdd();
    initGaugeField(1);
 
    if(rconf)
@@ -48,7 +51,12 @@ int main(int argc,char *argv[])
    for(n=0,nw=0;n<runParams.numConfs;n++)
    {
       gaugefieldUpdate(n+1,1,SIM_TYPE,SWEEP_TYPE);
+#if (MASTER_FIELD == 1)
+      /* the summed plaquette is only tracked for the whole master field */
       plaq=plaquette();
+#else
+      plaq=trackedPlaquette();
+#endif
       logging("plaq\t%.6f\n",plaq);
 
       if((((n-runParams.numThermConfs+1)%runParams.writeConfsFreq)==0)&&(n>runParams.numThermConfs)&&(runParams.writeConfsFreq>0))
@@ -0,0 +1,396 @@
+/*******************************************************************************
+*
+* File bench.c
+*
+* This software is distributed under the terms of the GNU General Public
+* License (GPL)
+*
+* Benchmark of the gauge field storage layout. Measures the time of the
+* plaquette, of the staples and of the Wilson-Dirac operator with the flat
+* gauge field (see gfield.h) and compares the plaquette and the staples with
+* those computed via a table of pointers to full link matrices,
+* sun_mat *u[VOL][DIM], as used before the flat field was introduced. The
+* normal operator D^dag*D with the scalar product (psi,D^dag*D*psi), as
+* needed in the CG, is timed with the fused kernel applyNormalWilsonOperator
+* and with separate calls of D, D^dag and realPartOfScalarProd. The
+* heatbath kernel (see heatbath.c) is timed on all links, in batches of
+* RANDOM_SLOTS with precomputed staples, and the sum of Re tr of the updated
+* links is printed (the gauge field itself is not changed).
+*
+* Finally one CG inversion of D^dag*D (see solv_cg.c) is timed with 1, 2,
+* 4, ... and the maximal number of OpenMP threads (OMP_NUM_THREADS or the
+* number of cores). The iteration count and the solution must be bitwise
+* the same for all thread numbers.
+*
+* The pointer table holds the original random links, so that with
+* compressed links (GAUGE_COMPRESS!=0) the comparison is an accuracy check
+* of the reconstruction against the full-matrix path. The Dirac operator
+* result can be compared with the one of a build with GAUGE_COMPRESS=0.
+*
+* Syntax: bench [nrep]
+*
+* The lattice size, gauge group, layout and compression are set in the
+* Makefile, e.g. make L=32 SUN=3 LAYOUT=2 COMPRESS=1
+*
+*******************************************************************************/
+
+#define MAIN_C
+
+#include"ranlxd.h"
+#include"modules.h"
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<math.h>
+#ifdef _OPENMP
+#include<omp.h>
+#endif
+
+#define HB_CHUNK (256*RANDOM_SLOTS)
+
+static sun_mat *lu,*(*tu)[DIM];
+
+static void initPointerTable(void)
+{
+   int n,dir;
+
+   lu=malloc(VOL*DIM*sizeof(sun_mat));
+   tu=malloc(VOL*sizeof(*tu));
+   error((lu==NULL)||(tu==NULL),"initPointerTable [bench.c]",
+         "Unable to allocate the pointer table!");
+
+   for(n=0;n<VOL;n++)
+      for(dir=0;dir<DIM;dir++)
+      {
+         tu[n][dir]=lu+n*DIM+dir;
+#if (SUN == 3)
+         su3RandomMatrix(tu[n][dir]);
+#elif (SUN == 2)
+         su2RandomMatrix(tu[n][dir]);
+#endif
+         gf_set(pu,n,dir,*tu[n][dir]);
+      }
+}
+
+static double maxLinkDeviation(void)
+{
+   int n,dir,c;
+   double *d1,*d2,dev;
+   sun_mat u;
+
+   dev=0.;
+   for(n=0;n<VOL;n++)
+      for(dir=0;dir<DIM;dir++)
+      {
+         gf_get(u,pu,n,dir);
+         d1=(double*)(&u);
+         d2=(double*)(tu[n][dir]);
+         for(c=0;c<SUNVOL;c++)
+            if(fabs(d1[c]-d2[c])>dev)
+               dev=fabs(d1[c]-d2[c]);
+      }
+
+   return dev;
+}
+
+static double plaquettePointerTable(void)
+{
+   int ii,jj,kk,n;
+   double plaq,tr;
+   sun_mat un[3];
+
+   plaq=0.;
+   for(ii=0;ii<VOL;ii++)
+      for(jj=0;jj<(DIM-1);jj++)
+         for(kk=jj+1;kk<DIM;kk++)
+         {
+            n=neib[ii][jj];
+            sun_mul(un[2],*tu[ii][jj],*tu[n][kk]);
+            n=neib[ii][kk];
+            sun_dag(un[0],*tu[n][jj]);
+            sun_mul(un[1],un[2],un[0]);
+            sun_dag(un[2],*tu[ii][kk]);
+            sun_mul(un[0],un[1],un[2]);
+            sun_trace(tr,un[0]);
+            plaq+=tr;
+         }
+
+   return plaq/(double)(SUN*NPLAQ*VOL);
+}
+
+static void staplesPointerTable(int n,int dir,sun_mat *stap)
+{
+   int kk,n1,n2;
+   sun_mat un[4];
+
+   sun_zero(un[3]);
+   for(kk=0;kk<DIM;kk++)
+   {
+      if(kk!=dir)
+      {
+         n1=neib[n][dir];
+         n2=neib[n][kk];
+         sun_mul_dag(un[1],*tu[n1][kk],*tu[n2][dir]);
+         sun_mul_dag(un[0],un[1],*tu[n][kk]);
+         sun_add(un[2],un[3],un[0]);
+
+         n2=neib[n][kk+DIM];
+         n1=neib[n2][dir];
+         sun_dag(un[0],*tu[n1][kk]);
+         sun_mul_dag(un[1],un[0],*tu[n2][dir]);
+         sun_mul(un[0],un[1],*tu[n2][kk]);
+         sun_add(un[3],un[2],un[0]);
+      }
+   }
+
+   *stap=un[3];
+}
+
+/* Returns the sum of Re tr of all staples, *dev is set to the maximal
+ * deviation of a staple component from the pointer table result */
+static double staplesSum(double *dev)
+{
+   int n,dir,c;
+   double tr,sum,*d1,*d2;
+   sun_mat st,str;
+
+   sum=0.;
+   for(n=0;n<VOL;n++)
+      for(dir=0;dir<DIM;dir++)
+      {
+         staples(pu,n,dir,&st);
+         sun_trace(tr,st);
+         sum+=tr;
+
+         if(dev!=NULL)
+         {
+            staplesPointerTable(n,dir,&str);
+            d1=(double*)(&st);
+            d2=(double*)(&str);
+            for(c=0;c<SUNVOL;c++)
+               if(fabs(d1[c]-d2[c])>(*dev))
+                  (*dev)=fabs(d1[c]-d2[c]);
+         }
+      }
+
+   return sum;
+}
+
+/* Applies heatbathKernel (see heatbath.c) to all links in batches of
+ * RANDOM_SLOTS, with the staples computed beforehand. The field is not
+ * changed. Returns the time, *acc is set to the mean acceptance and *tr to
+ * the sum of Re tr of the updated links */
+static double heatbathKernelTime(double beta,double *acc,double *tr)
+{
+   int l0,l,nl,k,nb;
+   double t1,t,a,s;
+   sun_mat *u,*stap;
+
+   u=malloc(HB_CHUNK*sizeof(sun_mat));
+   stap=malloc(HB_CHUNK*sizeof(sun_mat));
+   error((u==NULL)||(stap==NULL),"heatbathKernelTime [bench.c]",
+         "Unable to allocate the links and staples!");
+
+   t=a=(*tr)=0.;
+   for(l0=0;l0<VOL*DIM;l0+=HB_CHUNK)
+   {
+      nl=(VOL*DIM-l0<HB_CHUNK)?(VOL*DIM-l0):HB_CHUNK;
+      for(l=0;l<nl;l++)
+      {
+         gf_get(u[l],pu,(l0+l)/DIM,(l0+l)%DIM);
+         staples(pu,(l0+l)/DIM,(l0+l)%DIM,&stap[l]);
+      }
+
+      t1=getTime();
+      for(l=0;l<nl;l+=nb)
+      {
+         nb=(nl-l<RANDOM_SLOTS)?(nl-l):RANDOM_SLOTS;
+         for(k=0;k<nb;k++)
+            randomStreamSlot(k,1,(l0+l+k)/DIM,(l0+l+k)%DIM);
+         a+=heatbathKernel(nb,u+l,stap+l,beta);
+      }
+      t+=getTime()-t1;
+
+      for(l=0;l<nl;l++)
+      {
+         sun_trace(s,u[l]);
+         (*tr)+=s;
+      }
+   }
+   (*acc)=a/(double)(VOL*DIM);
+
+   free(stap);
+   free(u);
+
+   return t;
+}
+
+/* Times one CG inversion of D^dag*D*x=b for 1, 2, 4, ... and the maximal
+ * number of threads and checks that the solutions agree bitwise */
+static void cgScaling(sun_wferm *b)
+{
+   int nt,ntmax,niter,same;
+   double t1,t2,t0;
+   sun_wferm *x,*x0;
+
+   allocateFermionFieldsForCG();
+   allocateFermionField(&x);
+   allocateFermionField(&x0);
+
+#ifdef _OPENMP
+   ntmax=omp_get_max_threads();
+#else
+   ntmax=1;
+#endif
+   /* fixes the blocks of the reductions for ntmax threads */
+   reductionBlocks();
+
+   printf("CG scaling (eps 1e-10):\n");
+   t0=0.;
+   for(nt=1;;nt=(2*nt<ntmax)?(2*nt):ntmax)
+   {
+#ifdef _OPENMP
+      omp_set_num_threads(nt);
+#endif
+      setAllSpinorsToZero(x);
+      t1=getTime();
+      niter=cg(x,applyWilsonDiracOperator,applyComplexConjDiracOperator,
+               b,1.0e-10,10000);
+      t2=getTime();
+
+      if(nt==1)
+      {
+         t0=t2-t1;
+         copySpinors(x0,x);
+         same=1;
+      }
+      else
+         same=(memcmp(x,x0,VOL*sizeof(sun_wferm))==0);
+
+      printf("  %3d threads  %5d iterations  |x|^2 %.15e  %.4e s  speedup %.2f  %s\n",
+             nt,niter,globalSquareNorm(x),t2-t1,t0/(t2-t1),
+             same?"bitwise identical":"DIFFERENT");
+      if(nt==ntmax)
+         break;
+   }
+
+#ifdef _OPENMP
+   omp_set_num_threads(ntmax);
+#endif
+   deallocateFermionField(&x0);
+   deallocateFermionField(&x);
+   deallocateFermionFieldsForCG();
+}
+
+int main(int argc,char *argv[])
+{
+   int ir,nrep;
+   double t1,t2,tf,tp,ts,td,tn,tns,pf,pp,ss,nd,nn,nns,gb,dl,dst;
+   double th,hacc,htr;
+   sun_wferm *psi,*chi,*eta;
+
+   nrep=3;
+   if(argc>1)
+      nrep=atoi(argv[1]);
+   error(nrep<1,"main [bench.c]","Number of repetitions must be positive!");
+
+   PI=2.0*asin(1.0);
+   initTwoPi();
+   rlxd_init(1,17846);
+   initRandomStreams(17846);
+   initArrayOfNeighbours();
+   initGaugeField(0);
+   initPointerTable();
+
+   runParams.mass=0.1;
+   allocateFermionField(&psi);
+   allocateFermionField(&chi);
+   allocateFermionField(&eta);
+   ranlxd((double*)(psi),VOL*sizeof(sun_wferm)/sizeof(double));
+
+   printf("Lattice %dx%dx%dx%d, SU(%d), GAUGE_LAYOUT %d, GAUGE_COMPRESS %d, %d repetitions\n",
+          LENGT,LENGS1,LENGS2,LENGS3,SUN,GAUGE_LAYOUT,GAUGE_COMPRESS,nrep);
+   printf("Gauge field size %.3f GB (%d reals per link)\n",
+          (double)(GF_SIZE*sizeof(double))/1.0e9,GF_NREAL);
+
+   dl=maxLinkDeviation();
+   dst=0.;
+   staplesSum(&dst);
+
+   pf=pp=ss=nd=nn=nns=0.;
+   tf=tp=ts=td=tn=tns=0.;
+   for(ir=0;ir<nrep;ir++)
+   {
+      t1=getTime();
+      pf=plaquette();
+      t2=getTime();
+      tf+=t2-t1;
+
+      t1=getTime();
+      pp=plaquettePointerTable();
+      t2=getTime();
+      tp+=t2-t1;
+
+      t1=getTime();
+      ss=staplesSum(NULL);
+      t2=getTime();
+      ts+=t2-t1;
+
+      t1=getTime();
+      applyWilsonDiracOperator(chi,psi);
+      t2=getTime();
+      td+=t2-t1;
+      nd=globalSquareNorm(chi);
+
+      t1=getTime();
+      nn=applyNormalWilsonOperator(chi,psi,eta);
+      t2=getTime();
+      tn+=t2-t1;
+
+      t1=getTime();
+      applyWilsonDiracOperator(eta,psi);
+      applyComplexConjDiracOperator(chi,eta);
+      nns=realPartOfScalarProd(psi,chi);
+      t2=getTime();
+      tns+=t2-t1;
+   }
+   tf/=nrep;
+   tp/=nrep;
+   ts/=nrep;
+   td/=nrep;
+   tn/=nrep;
+   tns/=nrep;
+
+   /* 4 links are loaded per plaquette */
+   gb=(double)(4*NPLAQ)*(double)VOL*(double)(GF_NREAL*sizeof(double))/1.0e9;
+
+   printf("plaquette (flat field)    %.15f  %.4e s  %.3f GB/s\n",pf,tf,gb/tf);
+   printf("plaquette (pointer table) %.15f  %.4e s\n",pp,tp);
+   printf("staples   (flat field)    %.15e  %.4e s  %.3e s/link\n",
+          ss,ts,ts/(double)(VOL*DIM));
+   printf("Dirac operator |D psi|^2  %.15e  %.4e s\n",nd,td);
+   printf("D^dag*D fused    (psi,.)  %.15e  %.4e s\n",nn,tn);
+   printf("D^dag*D separate (psi,.)  %.15e  %.4e s\n",nns,tns);
+   printf("Deviation from the full-matrix path: links %.3e, staples %.3e, plaquette %.3e\n",
+          dl,dst,fabs(pf-pp));
+
+#if (SUN == 3)
+   runParams.beta=6.0;
+#elif (SUN == 2)
+   runParams.beta=2.3;
+#endif
+   th=heatbathKernelTime(runParams.beta,&hacc,&htr);
+   printf("heatbath kernel (beta %.1f) %.15e  %.4e s  %.3e s/link  acc %.4f\n",
+          runParams.beta,htr,th,th/(double)(VOL*DIM),hacc);
+
+   cgScaling(psi);
+
+   deallocateFermionField(&eta);
+   deallocateFermionField(&chi);
+   deallocateFermionField(&psi);
+   free(tu);
+   free(lu);
+   releaseGaugeField();
+
+   return 0;
+}
@@ -28,9 +28,11 @@
 void setGaugeFieldToCold(void)
 {
    int n, dir;
+   sun_mat u;
+   sun_unit(u);
    for (n = 0; n < VOL; n++)
       for (dir = 0; dir < DIM; dir++)
-         sun_unit(*pu[n][dir]);
+         gf_set(pu, n, dir, u);
 }
 
 int main(int argc, char *argv[])
@@ -44,9 +46,11 @@ int main(int argc, char *argv[])
 
    readInputFileForMeas(&seed, &sconf, &fconf, &econf, out_dir, argc, argv);
    rlxd_init(1, seed);
+   initRandomStreams(seed);
 
    setupOutputFilesForMeas(runParams.idForOutputFilesName, out_dir);
    initArrayOfNeighbours();
+   initArrayOfEvenOdd();
    initGaugeField(1);
 
    nt = ((measParams.tf - measParams.ts) / measParams.dt) + 1;
@@ -0,0 +1,39 @@
+/*******************************************************************************
+ *
+ * File convert_mf.c
+ *
+ * This software is distributed under the terms of the GNU General Public
+ * License (GPL)
+ *
+ * Converts master-field configurations between the lexicographic and the
+ * blocked file layout (see config_IO.c). The master-field and sublattice
+ * extents are those set in headers.h.
+ *
+ * Syntax: convert_mf -b [infile] [outfile]  (lexicographic -> blocked)
+ *         convert_mf -l [infile] [outfile]  (blocked -> lexicographic)
+ *
+ * Errors are written to the file SETUP_ERRORS, the log to convert_mf.log.
+ *
+ *******************************************************************************/
+
+#define MAIN_C
+
+#include "modules.h"
+#include <stdio.h>
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+    int layout;
+
+    sprintf(LOG_FILE, "SETUP_ERRORS");
+    error((argc != 4) || ((strcmp(argv[1], "-b") != 0) && (strcmp(argv[1], "-l") != 0)),
+          "main [convert_mf.c]", "Syntax: convert_mf -b|-l [infile] [outfile]");
+    layout = (strcmp(argv[1], "-b") == 0) ? 1 : 0;
+
+    sprintf(LOG_FILE, "convert_mf.log");
+    initGlobalArrays();
+    convertConfig(argv[2], argv[3], layout);
+
+    return 0;
+}
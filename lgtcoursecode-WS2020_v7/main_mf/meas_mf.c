@@ -0,0 +1,56 @@
+/*******************************************************************************
+ *
+ * File meas_mf.c
+ *
+ * This software is distributed under the terms of the GNU General Public
+ * License (GPL)
+ *
+ * Measures the plaquette, the action density per time slice and the
+ * Polyakov loop on master-field configurations in one pass over each file
+ * (see mf_meas.c), without updating them. The master-field and sublattice
+ * extents are those set in headers.h, the sublattice grid is not shifted.
+ *
+ * Syntax: meas_mf -b [beta] [config file] [config file] ...
+ *
+ * Errors are written to the file SETUP_ERRORS, the results to meas_mf.log:
+ *
+ * plaq  [plaquette]
+ * poly  [Re P] [Im P] [|P|^2]
+ * act   [t] [action density on time slice t]
+ *
+ *******************************************************************************/
+
+#define MAIN_C
+
+#include "modules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+    int n, t;
+    double plaq, tprof[LENGT_MF], ploop[3];
+
+    sprintf(LOG_FILE, "SETUP_ERRORS");
+    error((argc < 4) || (strcmp(argv[1], "-b") != 0), "main [meas_mf.c]",
+          "Syntax: meas_mf -b [beta] [config file] [config file] ...");
+    runParams.beta = atof(argv[2]);
+
+    sprintf(LOG_FILE, "meas_mf.log");
+    initGlobalArrays();
+
+    for (n = 3; n < argc; n++)
+    {
+        logging("\nMeasuring on configuration:\n %s\n", argv[n]);
+        plaq = measureMasterField(argv[n], tprof, ploop);
+
+        logging("plaq\t%.15e\n", plaq);
+        logging("poly\t%.15e\t%.15e\t%.15e\n", ploop[0], ploop[1], ploop[2]);
+        for (t = 0; t < LENGT_MF; t++)
+            logging("act\t%d\t%.15e\n", t, tprof[t]);
+    }
+    unmapConfig();
+
+    return 0;
+}
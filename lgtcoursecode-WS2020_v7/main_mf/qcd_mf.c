@@ -27,15 +27,20 @@
 
 int main(int argc, char *argv[])
 {
-    int n, nw, k;
+    int n, nw;
+#if ((MF_COLOUR == 0) && (MF_PIPELINE == 0))
+    int k;
+#endif
     bool write;
     int seed, rconf;
     char out_dir[NAME_SIZE];
     char cnfg_file[FULL_PATH_SIZE + 12];
-    double plaq;
+    double plaq, tprof[LENGT_MF], ploop[3];
 
     readInputFile(&seed, out_dir, &rconf, cnfg_file, argc, argv);
     rlxd_init(1, seed);
+    initRandomStreams(seed);
+    initThreadRandomNumbers(seed);
     initProgram(1);
 
     setupOutputFiles(runParams.idForOutputFilesName, out_dir);
@@ -44,6 +49,11 @@ int main(int argc, char *argv[])
     initGaugeField(0);
 
     initGlobalArrays();
+#if (MF_COLOUR == 1)
+    initMasterFieldColouring();
+#elif (MF_PIPELINE == 1)
+    initMasterFieldPipeline();
+#endif
 
 
 
@@ -62,23 +72,35 @@ int main(int argc, char *argv[])
     write = true;
     for (n = 0, nw = 0; n < runParams.numConfs; n++)
     {
-        if (write)
+        /* the plaquette of the master field is measured on the new file,
+         * which prepareConfig fills with the sublattice in pu, and after
+         * every PLAQ_RESYNC sweeps, and then tracked by gaugefieldUpdate */
+        if (write || ((n % PLAQ_RESYNC) == 0))
         {
-            sprintf(cnfg_file, "%s_n%d", CNFG_FILE, nw);
-            prepareConfig(cnfg_file);
-            write = false;
+            if (write)
+            {
+                sprintf(cnfg_file, "%s_n%d", CNFG_FILE, nw);
+                prepareConfig(cnfg_file);
+                write = false;
+            }
+            unshiftMasterField();
+            setTrackedPlaquette(measureMasterField(cnfg_file, tprof, ploop));
         }
 
-        plaq = 0.0;
+        shiftMasterField(n + 1);
+#if (MF_COLOUR == 1)
+        plaq = masterFieldSweepColoured(cnfg_file, n + 1, runParams.numLocalSweeps);
+#elif (MF_PIPELINE == 1)
+        plaq = masterFieldSweepPipelined(cnfg_file, n + 1, runParams.numLocalSweeps);
+#else
         for (k = 0; k < VOL_SL; k++)
         {
-            updateArrayOfIndexMF(k);
             readConfig(cnfg_file, k);
-            gaugefieldUpdate(n + 1, 1, SIM_TYPE, SWEEP_TYPE); // adjust number sweeps
-            plaq += plaquette();
+            gaugefieldUpdate(n + 1, runParams.numLocalSweeps, SIM_TYPE, SWEEP_TYPE);
             writeConfig(cnfg_file, k);
         }
-        plaq /= VOL_SL;
+        plaq = trackedPlaquette();
+#endif
         logging("plaq\t%.6f\n",plaq);
 
         if ((((n - runParams.numThermConfs + 1) % runParams.writeConfsFreq) == 0) && (n > runParams.numThermConfs) && (runParams.writeConfsFreq > 0))
@@ -90,6 +112,12 @@ int main(int argc, char *argv[])
         checkForErrors(1, 0);
     }
     
+#if (MF_COLOUR == 1)
+    releaseMasterFieldColouring();
+#elif (MF_PIPELINE == 1)
+    releaseMasterFieldPipeline();
+#endif
+    unmapConfig();
     releaseGaugeField();
 
     return 0;
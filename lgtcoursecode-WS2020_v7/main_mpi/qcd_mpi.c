@@ -0,0 +1,98 @@
+/*******************************************************************************
+ *
+ * File qcd_mpi.c
+ *
+ * This software is distributed under the terms of the GNU General Public
+ * License (GPL)
+ *
+ * Program for lattice gauge theory simulations with the lattice distributed
+ * over MPI processes. The lattice is the master field of headers.h, every
+ * process updates one of its VOL_SL sublattices with checkerboard sweeps
+ * and exchanges the outer layers with its neighbours (see mpi_comm.c). The
+ * program has to be started with VOL_SL processes, e.g.
+ *
+ * Syntax: mpirun -np [VOL_SL] qcd_mpi -i [input-filename] [-c [config]]
+ *
+ * The configurations are written in the master-field format of config_IO.c
+ * by all processes at once. With RNG_TYPE 1 the random numbers of a link
+ * update depend only on the seed, the sweep and the link (see philox.c), so
+ * the configurations do not depend on the number of processes and threads.
+ * With RNG_TYPE 0 the ranlxd generators of the processes are seeded with
+ * seed+rank*nthreads and the configurations depend on both.
+ *
+ * For usage instructions see the file ../README.txt
+ *
+ *******************************************************************************/
+
+#define MAIN_C
+
+#include "ranlxd.h"
+#include "modules.h"
+#include <stdio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+int main(int argc, char *argv[])
+{
+    int n, nw, nthreads;
+    int seed, rconf;
+    char out_dir[NAME_SIZE];
+    char cnfg_file[FULL_PATH_SIZE + 12];
+    double plaq;
+
+    initMpi(&argc, &argv);
+    readInputFile(&seed, out_dir, &rconf, cnfg_file, argc, argv);
+    error(runParams.mfShift != 0, "main [qcd_mpi.c]",
+          "The sublattice grid cannot be shifted with MPI (mfshift must be 0)!");
+
+    initRandomStreams(seed);
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#else
+    nthreads = 1;
+#endif
+    seed = (int)(((long)seed - 1 + (long)(mpiRank()) * nthreads) % 2147483647L) + 1;
+    rlxd_init(1, seed);
+    initThreadRandomNumbers(seed);
+    initProgram(1);
+
+    setupOutputFiles(runParams.idForOutputFilesName, out_dir);
+    printStartupInfo(seed, rconf, cnfg_file);
+
+    puSublattice = mpiRank();
+    initGaugeField(1);
+    initGlobalArrays();
+    initHaloExchange();
+
+    if (rconf)
+        readConfig(cnfg_file, mpiRank());
+    exchangeHalo();
+
+    checkForErrors(1, 0);
+
+    for (n = 0, nw = 0; n < runParams.numConfs; n++)
+    {
+        gaugefieldUpdate(n + 1, runParams.numLocalSweeps, SIM_TYPE, SWEEP_TYPE);
+        plaq = trackedPlaquette();
+        logging("plaq\t%.6f\n", plaq);
+
+        if ((((n - runParams.numThermConfs + 1) % runParams.writeConfsFreq) == 0) && (n > runParams.numThermConfs) && (runParams.writeConfsFreq > 0))
+        {
+            nw++;
+            sprintf(cnfg_file, "%s_n%d", CNFG_FILE, nw);
+            if (mpiRank() == 0)
+                writeHeaderToConfig(cnfg_file);
+            mpiBarrier();
+            writeConfig(cnfg_file, mpiRank());
+        }
+
+        checkForErrors(1, 0);
+    }
+
+    unmapConfig();
+    releaseGaugeField();
+    finalizeMpi();
+
+    return 0;
+}
@@ -41,7 +41,7 @@ int main(int argc, char *argv[])
     printf("%f\n", plaquette());
 
     printf("test2\n");
-    //printf("%f %f %f %f", (*pu[0][0]).c0, (*pu[0][0]).c1, (*pu[0][0]).c2, (*pu[0][0]).c3);
+    //printf("%f %f %f %f", pu[0], pu[1], pu[2], pu[3]);
     releaseGaugeField();
     /*runAllTests();*/
 
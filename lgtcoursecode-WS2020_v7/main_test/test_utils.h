@@ -27,7 +27,7 @@
 const double doubleRelativePrecision=1.e-12;
 unsigned int testCounter=0;
 enum fermionField {f_pointSource, f_cold, f_ascending};
-enum gaugeField {g_cold, g_ascending};
+enum gaugeField {g_cold, g_ascending, g_random};
 enum resultType {sum, squareNorm};
 
 typedef struct {
@@ -64,21 +64,48 @@ void setSpinorsToAscending(sun_wferm *f)
 void setGaugeFieldToCold(void)
 {
    int n,dir;
+   sun_mat u;
+   sun_unit(u);
    for(n=0;n<VOL;n++)
       for(dir=0;dir<DIM;dir++)
-         sun_unit(*pu[n][dir]);
+         gf_set(pu,n,dir,u);
 }
 
+/* The ascending matrices are not in SU(N). They are written to the field
+ * directly, since gf_set would pack them as SU(3) matrices with
+ * GAUGE_COMPRESS 1 or 2, and cannot be stored at all in that case */
 void setGaugeFieldToAscending(void)
 {
+#if (GAUGE_COMPRESS == 0)
    int n,dir,ii;
    double *du;
    for(n=0;n<VOL;n++)
       for(dir=0;dir<DIM;dir++)
       {
-         du=(double*)(pu[n][dir]);
-         for(ii=0;ii<SUNVOL;ii++,du++)
-            *du=(double)(ii+1);
+         du=pu+gf_offset(gf_link(n,dir));
+         for(ii=0;ii<SUNVOL;ii++)
+            du[(size_t)ii*GF_STRIDE]=(double)(ii+1);
+      }
+#else
+   error(1,"setGaugeFieldToAscending [test_utils.h]",
+         "The ascending gauge field requires GAUGE_COMPRESS 0!");
+#endif
+}
+
+void setGaugeFieldToRandom(void)
+{
+   int n,dir;
+   sun_mat u;
+   for(n=0;n<VOL;n++)
+      for(dir=0;dir<DIM;dir++)
+      {
+         randomStream(0,globalIndex(n),dir);
+#if (SUN == 3)
+         su3RandomMatrix(&u);
+#elif (SUN == 2)
+         su2RandomMatrix(&u);
+#endif
+         gf_set(pu,n,dir,u);
       }
 }
 
@@ -215,11 +242,13 @@ void initializeGaugeFieldBasedOnTestParameters(testParameters tP)
         setGaugeFieldToCold();
     else if (tP.gF == g_ascending)
         setGaugeFieldToAscending();
+    else if (tP.gF == g_random)
+        setGaugeFieldToRandom();
 #if(TEST_DEBUG!=0)
     else
     {
         fprintf(stderr,"ERROR: Invalid parameters for to testApplyWilsonDiracOperator!");
-        pu[0][0] = NULL;
+        releaseGaugeField();
     }
 #endif
 }
@@ -235,7 +264,7 @@ bool testApplyWilsonDiracOperator(testParameters tP)
     initializeFermionFieldBasedOnTestParameters(tP, f1);
     initializeGaugeFieldBasedOnTestParameters(tP);
 #if(TEST_DEBUG!=0)
-    if (pu[0][0]==NULL || f1==NULL)
+    if (pu==NULL || f1==NULL)
     {
         deallocateFermionField(&f1);
         deallocateFermionField(&f2);
@@ -263,7 +292,7 @@ bool testApplyWilsonDiracOperatorDagger(testParameters tP)
     initializeFermionFieldBasedOnTestParameters(tP, f1);
     initializeGaugeFieldBasedOnTestParameters(tP);
 #if(TEST_DEBUG!=0)
-    if (pu[0][0]==NULL || f1==NULL)
+    if (pu==NULL || f1==NULL)
     {
         deallocateFermionField(&s);
         deallocateFermionField(&f1);
@@ -411,6 +440,56 @@ bool test2ptFunction(testParameters tP)
     return testResult;
 }
 
+#if (RNG_TYPE == 1)
+/* Known answers of Philox4x32-10 from the Random123 library, each with the
+ * key, the counter and the output */
+bool testPhiloxKnownAnswers(testParameters tP)
+{
+    const unsigned int kat[3][10]={
+        {0x00000000, 0x00000000,
+         0x00000000, 0x00000000, 0x00000000, 0x00000000,
+         0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+        {0xffffffff, 0xffffffff,
+         0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+         0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+        {0xa4093822, 0x299f31d0,
+         0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344,
+         0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+    unsigned int x[4];
+    bool testResult = true;
+
+    (void)(tP);
+    for(int i=0; i<3; i++)
+    {
+        philoxWords(kat[i], kat[i]+2, x);
+        for(int j=0; j<4; j++)
+            testResult = testResult && (x[j]==kat[i][6+j]);
+    }
+    return testResult;
+}
+
+/* Compares the AVX2 functions of philox.c bitwise with the generic one, for
+ * counters whose first word wraps around within a batch and for counters
+ * taken from the generator itself. Passes if AVX2 is not available */
+bool testPhiloxAvx2(testParameters tP)
+{
+    const unsigned int keys[2][2]={{0x00000000, 0x00000000}, {0xa4093822, 0x299f31d0}};
+    unsigned int c[14][4]={
+        {0x00000000, 0x00000000, 0x00000000, 0x00000000},
+        {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+        {0xfffffffe, 0x00000001, 0x00000002, 0x03000000},
+        {0xfffffffd, 0x12345678, 0x9abcdef0, 0x0fedcba9}};
+    bool testResult = true;
+
+    (void)(tP);
+    for(int i=4; i<14; i++)
+        philoxWords(keys[1], c[i-1], c[i]);
+    for(int i=0; i<2; i++)
+        testResult = testResult && (checkPhiloxAvx2(keys[i], 14, c)<=0);
+    return testResult;
+}
+#endif
+
 bool runSingleTest(bool (*testFunction)(testParameters), testParameters tP, const char* testName){
     bool outcome=testFunction(tP);
     testCounter++;
@@ -426,15 +505,26 @@ void runAllTests(void){
     passed+=runSingleTest(testApplyWilsonDiracOperator, (testParameters){f_cold,      g_cold,      1.0, sum       },    "D.psi [f_cold,      g_cold,     1.0, sum       ]");
     passed+=runSingleTest(testApplyWilsonDiracOperator, (testParameters){f_ascending, g_cold,      1.0, squareNorm},    "D.psi [f_ascending, g_cold,     1.0, squareNorm]");
     passed+=runSingleTest(testApplyWilsonDiracOperator, (testParameters){f_ascending, g_cold,      1.0, sum       },    "D.psi [f_ascending, g_cold,     1.0, sum       ]");
+#if (GAUGE_COMPRESS == 0)
     passed+=runSingleTest(testApplyWilsonDiracOperator, (testParameters){f_cold,      g_ascending, 1.0, squareNorm},    "D.psi [f_cold,      g_ascending 1.0, squareNorm]");
     passed+=runSingleTest(testApplyWilsonDiracOperator, (testParameters){f_cold,      g_ascending, 1.0, sum       },    "D.psi [f_cold,      g_ascending 1.0, sum       ]");
     passed+=runSingleTest(testApplyWilsonDiracOperator, (testParameters){f_ascending, g_ascending, 1.0, squareNorm},    "D.psi [f_ascending, g_ascending 1.0, squareNorm]");
     passed+=runSingleTest(testApplyWilsonDiracOperator, (testParameters){f_ascending, g_ascending, 1.0, sum       },    "D.psi [f_ascending, g_ascending 1.0, sum       ]");
+#endif
 
     passed+=runSingleTest(testApplyWilsonDiracOperatorDagger, (testParameters){f_cold,      g_cold,      1.0, squareNorm},    "Ddagger_test [f_cold,      g_cold,      1.0]");
     passed+=runSingleTest(testApplyWilsonDiracOperatorDagger, (testParameters){f_ascending, g_cold,      1.0, squareNorm},    "Ddagger_test [f_ascending, g_cold,      1.0]");
+#if (GAUGE_COMPRESS == 0)
     passed+=runSingleTest(testApplyWilsonDiracOperatorDagger, (testParameters){f_cold,      g_ascending, 1.0, squareNorm},    "Ddagger_test [f_cold,      g_ascending, 1.0]");
     passed+=runSingleTest(testApplyWilsonDiracOperatorDagger, (testParameters){f_ascending, g_ascending, 1.0, squareNorm},    "Ddagger_test [f_ascending, g_ascending, 1.0]");
+#endif
+    passed+=runSingleTest(testApplyWilsonDiracOperatorDagger, (testParameters){f_cold,      g_random,    1.0, squareNorm},    "Ddagger_test [f_cold,      g_random,    1.0]");
+    passed+=runSingleTest(testApplyWilsonDiracOperatorDagger, (testParameters){f_ascending, g_random,    1.0, squareNorm},    "Ddagger_test [f_ascending, g_random,    1.0]");
+
+#if (RNG_TYPE == 1)
+    passed+=runSingleTest(testPhiloxKnownAnswers, (testParameters){f_cold, g_cold, 0.0, sum},    "Philox4x32-10 known answers");
+    passed+=runSingleTest(testPhiloxAvx2,         (testParameters){f_cold, g_cold, 0.0, sum},    "Philox4x32-10 AVX2 vs generic");
+#endif
 
     passed+=runSingleTest(testCGSolver, (testParameters){f_pointSource, g_cold, 2.0, squareNorm},    "chiral condensate [f_pointSource, g_cold, 2.0]");
 
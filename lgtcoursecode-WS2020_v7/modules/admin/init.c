@@ -21,42 +21,102 @@
  *      Initialises the neib arrays.
  *
  * void initGaugeField(int flag)
- *      Initialises the gauge field, i.e. the global sun_mat *pu[VOL][DIM]
- *      with either unity or random SU(N) matrices depending on the flag value.
+ *      Allocates the gauge field, i.e. the global double *pu (see gfield.h),
+ *      and initialises it with either unity or random SU(N) matrices
+ *      depending on the flag value. The random matrix of the link U_dir(n)
+ *      is drawn from the stream (0,globalIndex(n),dir) (see philox.c).
  *
  * void releaseGaugeField(void)
  *      Frees the memory allocated for the gauge field.
+ *
+ * void allocateGaugeField(double **u)
+ *      Allocates an aligned gauge field with GF_SIZE doubles in *u.
+ *
+ * void deallocateGaugeField(double **u)
+ *      Frees the gauge field *u.
+ *
+ * void copyGaugeField(double *u1, double *u2)
+ *      Copies the gauge field u1 into u2.
  * 
  * void initArrayOfSublattices(void)
  *      For master-field simulation. Initalizes array sl.
  * 
- * void initArrayOfPermutation(int size, int perm[][size])
- *      For master-field simulation. Saves all permutations of integers from 0 to size-1 in perm.
- * 
- * void updateArrayOfIndexMF(int)
- *      For master-field simulation. fills array index_mf[VOL2] depending on sublattice index. 
- *      Has to be called when going to different sublattice.
+ * void masterFieldExtents(int *ext, int *ext_mf)
+ *      For master-field simulation. Sets ext[DIM] and ext_mf[DIM] to the extents of the
+ *      sublattices and of the master field.
+ *
+ * void masterFieldCoordinates(int n_sl, int *xmf)
+ *      For master-field simulation. Fills xmf[LSUM2] with the master-field coordinates of
+ *      sublattice n_sl including its outer layers. xmf[off+x] with off the sum of the extents+2
+ *      of the preceding directions is the coordinate in direction dir of the points with
+ *      coordinate x (0<=x<=L_dir+1) on the bigger lattice, i.e. the origin of the sublattice
+ *      plus x-1 modulo the master-field extent. The master-field index of a point is thus
+ *      a sum over the directions and needs no tables of size VOL2. The origins include the
+ *      shift of the sublattice grid set by shiftMasterField.
+ *
+ * void shiftMasterField(int iup)
+ *      For master-field simulation. Sets the shift of the sublattice grid for the sweep iup
+ *      according to runParams.mfShift: 0 no shift, 1 shift by half the sublattice extent in
+ *      all directions for even iup, 2 random shift in [0,L_dir) in each direction (drawn
+ *      from the random stream (iup,0,DIM+1), see philox.c). The outer layers of the sublattices thus do not stay at the same
+ *      places of the master field. Must not be called while sublattices are read or written.
+ *
+ * void unshiftMasterField(void)
+ *      For master-field simulation. Resets the shift of the sublattice grid, e.g. before the
+ *      master field is measured (see mf_meas.c). Must not be called while sublattices are read
+ *      or written.
+ *
+ * int masterFieldShifted(void)
+ *      For master-field simulation. Returns 1 if the sublattice grid is shifted, 0 otherwise.
+ *
+ * long int indexMF(int n_sl, int n)
+ *      For master-field simulation. Returns the master-field index of the point n of the
+ *      bigger lattice of sublattice n_sl, using masterFieldCoordinates. The coordinates of
+ *      the last sublattice are kept by every thread until the grid is shifted.
+ *
+ * long int globalIndex(int n)
+ *      Returns the index of the point n of pu on the whole lattice, i.e. indexMF(puSublattice,n)
+ *      for master-field simulation and n otherwise. It labels the random number streams of
+ *      the updates (see philox.c), so that they do not depend on the decomposition.
+ *
  * 
  * void initArrayOfI(void)
  *      For master-field simulation. initializes array i.
  * 
  * void initGlobalArrays(void)
- *      For master-field simulation. Wrapper for all init functions. not including updateArrayOfIndexMF.
+ *      For master-field simulation. Wrapper for all init functions.
+ *
+ * void initArrayOfEvenOdd(void)
+ *      Initialises the array ieo, which contains the indices of the VOL/2
+ *      even points followed by those of the VOL/2 odd points of the
+ *      (sub-)lattice, and its inverse ipeo, which contains the position
+ *      of each point in this even-odd ordering.
+ *
+ * void initThreadRandomNumbers(int seed)
+ *      Initialises the random number generators of all OpenMP threads.
+ *      Thread 0 keeps the state set by rlxd_init(level,seed), thread t>0
+ *      is initialised with seed+t. Without OpenMP it does nothing. The
+ *      updates only use ranlxd with RNG_TYPE 0 (see philox.c).
  *******************************************************************************/
 
 #define INIT_C
 
 #include "modules.h"
+#include "ranlxd.h"
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define DEBUG_INIT 0
 
 void initProgram(int itype)
 {
 
-    error((runParams.numConfs <= 0) || (runParams.decorSteps < 0) || (runParams.numThermConfs < 0) ||
+    error((runParams.numConfs <= 0) || (runParams.decorSteps < 0) || (runParams.numThermConfs < 0) || (runParams.numOverrelax < 0) ||
+              (runParams.numLocalSweeps < 1) || (runParams.mfShift < 0) || (runParams.mfShift > 2) ||
               ((((runParams.numConfs - runParams.numThermConfs) % runParams.writeConfsFreq) != 0) && (runParams.writeConfsFreq > 0)),
           "initProgram [init.c]", "Error in run parameters");
 
@@ -65,6 +125,46 @@ void initProgram(int itype)
     initTwoPi();
 }
 
+void initArrayOfEvenOdd(void)
+{
+    int n, x, dir, parity, ne, no;
+    int latticeExtent[DIM];
+
+    checkpoint("initArrayOfEvenOdd -- in");
+
+    latticeExtent[0] = LENGT;
+    latticeExtent[1] = LENGS1;
+#if (DIM > 2)
+    latticeExtent[2] = LENGS2;
+#endif
+#if (DIM > 3)
+    latticeExtent[3] = LENGS3;
+#endif
+
+    for (n = 0, ne = 0, no = VOL / 2; n < VOL; n++)
+    {
+        parity = 0;
+        for (dir = DIM - 1, x = n; dir >= 0; dir--)
+        {
+            parity += x % latticeExtent[dir];
+            x /= latticeExtent[dir];
+        }
+
+        if ((parity % 2) == 0)
+        {
+            ipeo[n] = ne;
+            ieo[ne++] = n;
+        }
+        else
+        {
+            ipeo[n] = no;
+            ieo[no++] = n;
+        }
+    }
+
+    checkpoint("initArrayOfEvenOdd -- out");
+}
+
 #if (MASTER_FIELD == 1)
 void initArrayOfSubLattices(void)
 {
@@ -151,309 +251,123 @@ void initArrayOfSubLattices(void)
 
 /************************************************************************************************************************/
 
-static void initArrayOfPermutations(int size, int perm[][size])
+void masterFieldExtents(int *ext, int *ext_mf)
 {
-    int init[size], p[size + 1];
-    int num_perms = fact(size);
-    int i, j, k, count;
-    for (i = 0; i < size; i++)
-    {
-        init[i] = i;
-    }
-    for (i = 0; i < size; i++)
-    {
-        p[i] = 0;
-    }
+    ext[0] = LENGT;
+    ext_mf[0] = LENGT_MF;
+#if (DIM > 1)
+    ext[1] = LENGS1;
+    ext_mf[1] = LENGS1_MF;
+#endif
+#if (DIM > 2)
+    ext[2] = LENGS2;
+    ext_mf[2] = LENGS2_MF;
+#endif
+#if (DIM > 3)
+    ext[3] = LENGS3;
+    ext_mf[3] = LENGS3_MF;
+#endif
+}
 
-    count = 0;
-    for (i = 0; i < size; i++)
-    {
-        perm[count][i] = init[i];
-    }
+static int gridShift[DIM] = {0}, gridVersion = 0;
+/* coordinates of the sublattice last passed to indexMF by the thread */
+static int cacheSl = -1, cacheVersion = -1, cacheXmf[LSUM2];
+#pragma omp threadprivate(cacheSl, cacheVersion, cacheXmf)
 
-    i = 1;
-    while (i < size)
-    {
-        if (p[i] < i)
-        {
-            if (i % 2 == 0)
-            {
-                swap(&init[0], &init[i]);
-            }
-            else
-            {
-                swap(&init[p[i]], &init[i]);
-            }
+void shiftMasterField(int iup)
+{
+    int dir;
+    int latticeExtent[DIM], latticeExtent_mf[DIM];
+    double r[DIM];
 
-            count++;
-            for (j = 0; j < num_perms; j++)
-            {
-                for (k = 0; k < size; k++)
-                {
-                    perm[count][k] = init[k];
-                }
-            }
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
 
-            p[i]++;
-            i = 1;
-        }
+    if (runParams.mfShift == 2)
+    {
+        randomStream(iup, 0, DIM + 1);
+        randomNumbers(r, DIM);
+    }
+    for (dir = 0; dir < DIM; dir++)
+    {
+        if (runParams.mfShift == 1)
+            gridShift[dir] = ((iup % 2) == 0) ? (latticeExtent[dir] / 2) : 0;
+        else if (runParams.mfShift == 2)
+            gridShift[dir] = (int)(r[dir] * latticeExtent[dir]) % latticeExtent[dir];
         else
-        {
-            p[i] = 0;
-            i++;
-        }
+            gridShift[dir] = 0;
     }
+    gridVersion++;
 }
 
-void updateArrayOfIndexMF(int n_sl)
+void unshiftMasterField(void)
 {
-    long int latticeExtent[DIM], latticeExtent_mf[DIM];
-    long int volumeFactor[DIM], volumeFactor_big[DIM], volumeFactor_mf[DIM];
-    long int ix[DIM], ix_big[DIM], ix_mf[DIM], coord_big[DIM], coord_mf[DIM];
-    long int in, dir, dir2, index, index_m, border_count, num_perms;
-    bool border[2 * DIM];
-    double t1, t2;
-
-    checkpoint("initArrayOfIndexMF -- in");
-    t1 = getTime();
+    int dir;
 
-#if (DIM == 2)
-    latticeExtent[0] = LENGT;
-    latticeExtent[1] = LENGS1;
-    latticeExtent_mf[0] = LENGT_MF;
-    latticeExtent_mf[1] = LENGS1_MF;
-    volumeFactor_mf[0] = LENGS1_MF;
-    volumeFactor_mf[1] = 1;
-    volumeFactor_big[0] = (LENGS1 + 2);
-    volumeFactor_big[1] = 1;
-    volumeFactor[0] = LENGS1;
-    volumeFactor[1] = 1;
-#elif (DIM == 3)
-    latticeExtent[0] = LENGT;
-    latticeExtent[1] = LENGS1;
-    latticeExtent[2] = LENGS2;
-    latticeExtent_mf[0] = LENGT_MF;
-    latticeExtent_mf[1] = LENGS1_MF;
-    latticeExtent_mf[2] = LENGS2_MF;
-    volumeFactor_mf[0] = LENGS1_MF * LENGS2_MF;
-    volumeFactor_mf[1] = LENGS2_MF;
-    volumeFactor_mf[2] = 1;
-    volumeFactor_big[0] = (LENGS1 + 2) * (LENGS2 + 2);
-    volumeFactor_big[1] = (LENGS2 + 2);
-    volumeFactor_big[2] = 1;
-    volumeFactor[0] = LENGS1 * LENGS2;
-    volumeFactor[1] = LENGS2;
-    volumeFactor[2] = 1;
-#elif (DIM == 4)
-    latticeExtent[0] = LENGT;
-    latticeExtent[1] = LENGS1;
-    latticeExtent[2] = LENGS2;
-    latticeExtent[3] = LENGS3;
-    latticeExtent_mf[0] = LENGT_MF;
-    latticeExtent_mf[1] = LENGS1_MF;
-    latticeExtent_mf[2] = LENGS2_MF;
-    latticeExtent_mf[3] = LENGS3_MF;
-    volumeFactor_mf[0] = LENGS1_MF * LENGS2_MF * LENGS3_MF;
-    volumeFactor_mf[1] = LENGS2_MF * LENGS3_MF;
-    volumeFactor_mf[2] = LENGS3_MF;
-    volumeFactor_mf[3] = 1;
-    volumeFactor_big[0] = (LENGS1 + 2) * (LENGS2 + 2) * (LENGS3 + 2);
-    volumeFactor_big[1] = (LENGS2 + 2) * (LENGS3 + 2);
-    volumeFactor_big[2] = (LENGS3 + 2);
-    volumeFactor_big[3] = 1;
-    volumeFactor[0] = LENGS1 * LENGS2 * LENGS3;
-    volumeFactor[1] = LENGS2 * LENGS3;
-    volumeFactor[2] = LENGS3;
-    volumeFactor[3] = 1;
-#endif
     for (dir = 0; dir < DIM; dir++)
-    {
-        ix[dir] = 0;
-        ix_big[dir] = 0;
-        ix_mf[dir] = 0;
-        coord_big[dir] = 0;
-        coord_mf[dir] = 0;
-    }
+        gridShift[dir] = 0;
+    gridVersion++;
+}
 
-    index = 0;
-    for (in = 0; in < VOL; in++) /* calculate index_mf for core part */
-    {
-        index_mf[i[in]] = index + sl[n_sl];
+int masterFieldShifted(void)
+{
+    int dir;
 
-        for (dir = DIM - 1; dir >= 0; dir--) /* calculate coordinates of small lattice*/
-        {
-            if (ix[dir] + 1 != latticeExtent[dir])
-            {
-                ix[dir]++;
-                break;
-            }
-            else
-            {
-                ix[dir] = 0;
-            }
-        }
-        index = 0;
-        for (int dir = 0; dir < DIM; dir++) /* calculate lattice site index from coordinate */
-        {
-            index += ix[dir] * volumeFactor_mf[dir];
-        }
+    for (dir = 0; dir < DIM; dir++)
+    {
+        if (gridShift[dir] != 0)
+            return 1;
     }
 
-    for (in = 0; in < VOL; in++) /* calculate index_mf for outer layers*/
-    {
-        index = in;
-        for (dir = 0; dir < DIM; dir++)
-        {
-            ix[dir] = index / volumeFactor[dir];
-            index = index % volumeFactor[dir];
-        }
+    return 0;
+}
 
-        index = i[in];
-        for (dir = 0; dir < DIM; dir++)
-        {
-            ix_big[dir] = index / volumeFactor_big[dir];
-            index = index % volumeFactor_big[dir];
-        }
+void masterFieldCoordinates(int n_sl, int *xmf)
+{
+    int dir, x, off, b;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], origin[DIM];
 
-        index = index_mf[i[in]];
-        for (dir = 0; dir < DIM; dir++)
-        {
-            ix_mf[dir] = index / volumeFactor_mf[dir];
-            index = index % volumeFactor_mf[dir];
-        }
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
 
-        border_count = 0;
-        for (dir = 0; dir < DIM; dir++)
-        {
-            border[dir] = false;
-            border[dir + DIM] = false;
-            if (ix[dir] == 0)
-            {
-                border[dir + DIM] = true;
-                border_count++;
-            }
-            else if (ix[dir] == latticeExtent[dir] - 1)
-            {
-                border[dir] = true;
-                border_count++;
-            }
-        }
-
-        num_perms = fact(border_count);
-        int borders[border_count];
-        int perms[num_perms][border_count];
-        border_count = 0;
-        for (dir = 0; dir < DIM; dir++)
-        {
-            if (border[dir + DIM] == true)
-            {
-                borders[border_count] = (dir + DIM);
-                border_count++;
-            }
-            else if (border[dir] == true)
-            {
-                borders[border_count] = dir;
-                border_count++;
-            }
-        }
+    /* origin of the sublattice, the last direction runs fastest as in sl */
+    for (dir = DIM - 1; dir >= 0; dir--)
+    {
+        b = latticeExtent_mf[dir] / latticeExtent[dir];
+        origin[dir] = (n_sl % b) * latticeExtent[dir] + gridShift[dir];
+        n_sl /= b;
+    }
 
-        if (border_count == 1)
-        {
-            for (int i = 0; i < num_perms; i++)
-            {
-                for (int j = 0; j < border_count; j++)
-                {
-                    perms[i][j] = perm1[i][j];
-                }
-            }
-        }
-        else if (border_count == 2)
-        {
-            for (int i = 0; i < num_perms; i++)
-            {
-                for (int j = 0; j < border_count; j++)
-                {
-                    perms[i][j] = perm2[i][j];
-                }
-            }
-        }
-        else if (border_count == 3)
-        {
-            for (int i = 0; i < num_perms; i++)
-            {
-                for (int j = 0; j < border_count; j++)
-                {
-                    perms[i][j] = perm3[i][j];
-                }
-            }
-        }
-        else if (border_count == 4)
-        {
-            for (int i = 0; i < num_perms; i++)
-            {
-                for (int j = 0; j < border_count; j++)
-                {
-                    perms[i][j] = perm4[i][j];
-                }
-            }
-        }
-        //initArrayOfPermutations(border_count, perms);
+    for (dir = 0, off = 0; dir < DIM; off += latticeExtent[dir] + 2, dir++)
+    {
+        for (x = 0; x < latticeExtent[dir] + 2; x++)
+            xmf[off + x] = (origin[dir] + x - 1 + latticeExtent_mf[dir]) % latticeExtent_mf[dir];
+    }
+}
 
-        for (dir = 0; dir < DIM; dir++)
-        {
-            coord_mf[dir] = ix_mf[dir];
-            coord_big[dir] = ix_big[dir];
-        }
+long int indexMF(int n_sl, int n)
+{
+    int dir, off;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], x[DIM];
+    long int m;
 
-        for (int i = 0; i < num_perms; i++)
-        {
-            for (int j = 0; j < border_count; j++)
-            {
-                dir = borders[perms[i][j]];
-                if (dir < DIM)
-                {
-                    ix_mf[dir]++;
-                    ix_big[dir]++;
-                }
-                else
-                {
-                    dir -= DIM;
-                    ix_mf[dir]--;
-                    ix_big[dir]--;
-                }
-                ix_mf[dir] = (ix_mf[dir] + latticeExtent_mf[dir]) % latticeExtent_mf[dir];
-
-                index_m = 0;
-                index = 0;
-                for (dir2 = 0; dir2 < DIM; dir2++)
-                {
-                    index += volumeFactor_big[dir2] * ix_big[dir2];
-                    index_m += volumeFactor_mf[dir2] * ix_mf[dir2];
-                }
-                index_mf[index] = index_m;
-            }
-            for (dir = 0; dir < DIM; dir++)
-            {
-                ix_mf[dir] = coord_mf[dir];
-                ix_big[dir] = coord_big[dir];
-            }
-        }
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+    if ((n_sl != cacheSl) || (gridVersion != cacheVersion))
+    {
+        masterFieldCoordinates(n_sl, cacheXmf);
+        cacheSl = n_sl;
+        cacheVersion = gridVersion;
     }
 
-#if (DEBUG_INIT == 1)
-    logging("\n\n\nin\t-->\ti\n\n");
-
-    for (in = 0; in < VOL2; in++)
+    for (dir = DIM - 1; dir >= 0; dir--)
     {
-        logging("%d\t-->\t%d\n", in, index_mf[in]);
+        x[dir] = n % (latticeExtent[dir] + 2);
+        n /= latticeExtent[dir] + 2;
     }
 
-#endif
+    m = 0;
+    for (dir = 0, off = 0; dir < DIM; off += latticeExtent[dir] + 2, dir++)
+        m = m * latticeExtent_mf[dir] + cacheXmf[off + x[dir]];
 
-    t2 = getTime();
-    logging("\nArray index_mf updated at position %d (took %.3e sec)!\n", n_sl, t2 - t1);
-    checkpoint("initArrayOfIndexMF -- out");
-    return;
+    return m;
 }
 
 void initArrayOfNeighbours(void) // works with VOL2 stuff
@@ -585,85 +499,10 @@ void initGlobalArrays(void)
     initArrayOfNeighbours();
     initArrayOfSubLattices();
     initArrayOfI();
-    initArrayOfPermutations(1, perm1);
-    initArrayOfPermutations(2, perm2);
-    initArrayOfPermutations(3, perm3);
-    initArrayOfPermutations(4, perm4);
+    initArrayOfEvenOdd();
     return;
 }
 
-void initGaugeField(int flag)
-{
-    sun_mat *iu = NULL, *zu, ini;
-    int ind, dir;
-
-    checkpoint("init_gauge");
-
-    error((flag != 0) && (flag != 1), "init_gauge [start.c]",
-          "Wrong flag! Cannot initiate gauge field!");
-
-    iu = malloc(DIM * VOL2 * sizeof(sun_mat));
-    error(iu == NULL, "init_gauge [start.c]",
-          "Unable to allocate gauge field array!");
-
-    if (flag == 0)
-    {
-        sun_unit(ini);
-    }
-    for (ind = 0, zu = iu; ind < VOL2; ind++)
-    {
-        for (dir = 0; dir < DIM; dir++, zu++)
-        {
-            pu[ind][dir] = zu;
-            if (flag == 0)
-            {
-                *pu[ind][dir] = ini;
-            }
-            else if (flag == 1)
-            {
-#if (SUN == 3)
-                su3RandomMatrix(pu[ind][dir]);
-#elif (SUN == 2)
-                su2RandomMatrix(pu[ind][dir]);
-#endif
-            }
-        }
-    }
-}
-
-void allocateGaugeField(sun_mat *u[VOL2][DIM])
-{
-    sun_mat *iu = NULL, *zu;
-    int ind, dir;
-
-    checkpoint("allocate_gauge");
-
-    iu = malloc(DIM * VOL2 * sizeof(sun_mat));
-    error(iu == NULL, "allocate_gauge [start.c]",
-          "Unable to allocate gauge field array!");
-
-    for (ind = 0, zu = iu; ind < VOL2; ind++)
-    {
-        for (dir = 0; dir < DIM; dir++, zu++)
-        {
-            u[ind][dir] = zu;
-        }
-    }
-}
-
-void deallocateGaugeField(sun_mat *u[VOL2][DIM])
-{
-    free(u[0][0]);
-}
-
-void copyGaugeField(sun_mat *u1[VOL2][DIM], sun_mat *u2[VOL2][DIM])
-{
-    int ii, jj;
-    for (ii = 0; ii < VOL2; ii++)
-        for (jj = 0; jj < DIM; jj++)
-            *u2[ii][jj] = *u1[ii][jj];
-}
-
 #elif (MASTER_FIELD == 0)
 void initArrayOfNeighbours(void)
 {
@@ -755,9 +594,34 @@ void initArrayOfNeighbours(void)
     return;
 }
 
+#endif
+
+long int globalIndex(int n)
+{
+#if (MASTER_FIELD == 1)
+    return indexMF(puSublattice, n);
+#else
+    return n;
+#endif
+}
+
+void allocateGaugeField(double **u)
+{
+    void *iu = NULL;
+    int ifail;
+
+    checkpoint("allocate_gauge");
+
+    ifail = posix_memalign(&iu, GF_ALIGN, GF_SIZE * sizeof(double));
+    error((ifail != 0) || (iu == NULL), "allocate_gauge [start.c]",
+          "Unable to allocate gauge field array!");
+
+    *u = iu;
+}
+
 void initGaugeField(int flag)
 {
-    sun_mat *iu = NULL, *zu, ini;
+    sun_mat ini;
     int ind, dir;
 
     checkpoint("init_gauge");
@@ -765,70 +629,43 @@ void initGaugeField(int flag)
     error((flag != 0) && (flag != 1), "init_gauge [start.c]",
           "Wrong flag! Cannot initiate gauge field!");
 
-    iu = malloc(DIM * VOL * sizeof(sun_mat));
-    error(iu == NULL, "init_gauge [start.c]",
-          "Unable to allocate gauge field array!");
+    allocateGaugeField(&pu);
 
     if (flag == 0)
     {
         sun_unit(ini);
     }
-    for (ind = 0, zu = iu; ind < VOL; ind++)
+    for (ind = 0; ind < VOL_GF; ind++)
     {
-        for (dir = 0; dir < DIM; dir++, zu++)
+        for (dir = 0; dir < DIM; dir++)
         {
-            pu[ind][dir] = zu;
-            if (flag == 0)
-            {
-                *pu[ind][dir] = ini;
-            }
-            else if (flag == 1)
+            if (flag == 1)
             {
+                randomStream(0, globalIndex(ind), dir);
 #if (SUN == 3)
-                su3RandomMatrix(pu[ind][dir]);
+                su3RandomMatrix(&ini);
 #elif (SUN == 2)
-                su2RandomMatrix(pu[ind][dir]);
+                su2RandomMatrix(&ini);
 #endif
             }
+            gf_set(pu, ind, dir, ini);
         }
     }
 }
 
-void allocateGaugeField(sun_mat *u[VOL][DIM])
+void deallocateGaugeField(double **u)
 {
-    sun_mat *iu = NULL, *zu;
-    int ind, dir;
-
-    checkpoint("allocate_gauge");
-
-    iu = malloc(DIM * VOL * sizeof(sun_mat));
-    error(iu == NULL, "allocate_gauge [start.c]",
-          "Unable to allocate gauge field array!");
-
-    for (ind = 0, zu = iu; ind < VOL; ind++)
-    {
-        for (dir = 0; dir < DIM; dir++, zu++)
-        {
-            u[ind][dir] = zu;
-        }
-    }
-}
-
-void deallocateGaugeField(sun_mat *u[VOL][DIM])
-{
-    free(u[0][0]);
+    free(*u);
+    *u = NULL;
 }
 
-void copyGaugeField(sun_mat *u1[VOL][DIM], sun_mat *u2[VOL][DIM])
+void copyGaugeField(double *u1, double *u2)
 {
-    int ii, jj;
-    for (ii = 0; ii < VOL; ii++)
-        for (jj = 0; jj < DIM; jj++)
-            *u2[ii][jj] = *u1[ii][jj];
+    size_t ii;
+    for (ii = 0; ii < GF_SIZE; ii++)
+        u2[ii] = u1[ii];
 }
 
-#endif
-
 void allocateFermionField(sun_wferm **f)
 {
     sun_wferm *s;
@@ -845,5 +682,21 @@ void deallocateFermionField(sun_wferm **f)
 
 void releaseGaugeField(void)
 {
-    free(pu[0][0]);
+    deallocateGaugeField(&pu);
+}
+
+void initThreadRandomNumbers(int seed)
+{
+#ifdef _OPENMP
+    omp_set_dynamic(0);
+
+#pragma omp parallel
+    {
+        int tid;
+
+        tid = omp_get_thread_num();
+        if (tid > 0)
+            rlxd_init(1, (int)(((long)seed - 1 + tid) % 2147483647L) + 1);
+    }
+#endif
 }
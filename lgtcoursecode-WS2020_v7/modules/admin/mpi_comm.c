@@ -0,0 +1,399 @@
+
+/*******************************************************************************
+ *
+ * File mpi_comm.c
+ *
+ * This software is distributed under the terms of the GNU General Public
+ * License (GPL)
+ *
+ * Includes the MPI domain decomposition (MPI_PARALLEL 1 in headers.h). The
+ * lattice is the master field of headers.h and every process holds one of
+ * its VOL_SL sublattices, the process rank being the sublattice index (see
+ * initArrayOfSubLattices in init.c). The lattice is thus decomposed in the
+ * directions in which the master-field extent differs from the sublattice
+ * extent. The outer layers of the bigger lattice of the sublattice (see
+ * initArrayOfI in init.c) hold the links of the neighbouring processes.
+ *
+ * Externally accessible functions:
+ *
+ * void initMpi(int *argc, char ***argv)
+ *      Initialises MPI. Only the master thread of a process calls MPI
+ *      functions.
+ *
+ * void finalizeMpi(void)
+ *      Frees the buffers of the halo exchange and finalises MPI.
+ *
+ * void abortMpi(int code)
+ *      Aborts all processes with the given error code, or only the calling
+ *      one if MPI has not been initialised.
+ *
+ * int mpiRank(void)
+ * int mpiSize(void)
+ *      Return the rank of the process and the number of processes.
+ *
+ * void mpiBarrier(void)
+ *      Synchronises all processes.
+ *
+ * void initHaloExchange(void)
+ *      Sets up the halo exchange and the lists of the checkerboard sweeps.
+ *      The number of processes must be VOL_SL, the sublattice extents must
+ *      be even and the global arrays must have been initialised (see
+ *      initGlobalArrays in init.c).
+ *
+ * void startHaloExchange(int dir)
+ *      Starts the nonblocking exchange of the outer layers of the gauge
+ *      field pu with all 3^DIM-1 neighbouring processes, for the links in
+ *      direction dir or, if dir<0, for all links. The edges and corners are
+ *      exchanged directly with the diagonal neighbours. The links of the
+ *      core may be updated meanwhile, except those on its boundary.
+ *
+ * void finishHaloExchange(void)
+ *      Waits for the exchange started by startHaloExchange and stores the
+ *      received links in the outer layers of pu. Does nothing if no
+ *      exchange is pending.
+ *
+ * void exchangeHalo(void)
+ *      Exchanges all links of the outer layers of pu.
+ *
+ * double mpiGlobalSum(double x)
+ *      Returns the sum of x over all processes, added up in the order of
+ *      the ranks, such that it is the same on all processes.
+ *
+ * int checkerboardList(int par, int **lst)
+ *      Sets *lst to the indices on the bigger lattice of the VOL/2 points
+ *      of parity par and returns the number nint of points at the beginning
+ *      of the list which are not on the boundary of the core. The links of
+ *      these points can be updated without the outer layers.
+ *
+ * The links are exchanged in the storage format of gfield.h, so the outer
+ * layers are bitwise copies of the links of the neighbouring processes.
+ *
+ *******************************************************************************/
+
+#define MPI_COMM_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "headers.h"
+#include "modules.h"
+
+#if (MPI_PARALLEL == 1)
+#include <mpi.h>
+
+#if (DIM == 2)
+#define NOFFSET 8
+#elif (DIM == 3)
+#define NOFFSET 26
+#elif (DIM == 4)
+#define NOFFSET 80
+#endif
+
+static int init = 0, rank = 0, nrank = 1, pending = 0, pending_dir;
+static int nbr_recv[NOFFSET], nbr_send[NOFFSET], npt[NOFFSET];
+static int *send_idx[NOFFSET], *recv_idx[NOFFSET];
+static double *send_buf[NOFFSET], *recv_buf[NOFFSET];
+static MPI_Request req[2 * NOFFSET];
+static int cb_list[2][VOL / 2], cb_nint[2];
+
+void initMpi(int *argc, char ***argv)
+{
+    int provided;
+
+    MPI_Init_thread(argc, argv, MPI_THREAD_FUNNELED, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nrank);
+    error(provided < MPI_THREAD_FUNNELED, "initMpi [mpi_comm.c]",
+          "MPI does not support MPI_THREAD_FUNNELED!");
+}
+
+void finalizeMpi(void)
+{
+    int k;
+
+    if (init == 1)
+    {
+        for (k = 0; k < NOFFSET; k++)
+        {
+            free(send_idx[k]);
+            free(recv_idx[k]);
+            free(send_buf[k]);
+            free(recv_buf[k]);
+        }
+        init = 0;
+    }
+    MPI_Finalize();
+}
+
+void abortMpi(int code)
+{
+    int flag;
+
+    MPI_Initialized(&flag);
+    if (flag)
+        MPI_Abort(MPI_COMM_WORLD, code);
+    exit(code);
+}
+
+int mpiRank(void)
+{
+    return rank;
+}
+
+int mpiSize(void)
+{
+    return nrank;
+}
+
+void mpiBarrier(void)
+{
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+/* Fills idx with the indices on the bigger lattice of the points with
+ * lo[dir]<=x[dir]<=hi[dir], the last direction running fastest */
+static int regionIndices(int *lo, int *hi, int *idx)
+{
+    int n, dir, np;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], x[DIM];
+
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+
+    for (dir = 0; dir < DIM; dir++)
+        x[dir] = lo[dir];
+    for (np = 0;;)
+    {
+        for (dir = 0, n = 0; dir < DIM; dir++)
+            n = n * (latticeExtent[dir] + 2) + x[dir];
+        idx[np++] = n;
+
+        for (dir = DIM - 1; dir >= 0; dir--)
+        {
+            if (x[dir] < hi[dir])
+            {
+                x[dir]++;
+                break;
+            }
+            x[dir] = lo[dir];
+        }
+        if (dir < 0)
+            break;
+    }
+
+    return np;
+}
+
+/* Returns 1 if the point n (normal index) lies on the boundary of the core */
+static int onBoundary(int n)
+{
+    int dir, x;
+    int latticeExtent[DIM], latticeExtent_mf[DIM];
+
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+
+    for (dir = DIM - 1; dir >= 0; dir--)
+    {
+        x = n % latticeExtent[dir];
+        n /= latticeExtent[dir];
+        if ((x == 0) || (x == latticeExtent[dir] - 1))
+            return 1;
+    }
+
+    return 0;
+}
+
+void initHaloExchange(void)
+{
+    int k, e, m, dir, b, np, r, par, n, nb;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], frac[DIM], coord[DIM];
+    int off[DIM], lo[DIM], hi[DIM];
+
+    checkpoint("initHaloExchange -- in");
+
+    error(init != 0, "initHaloExchange [mpi_comm.c]", "Halo exchange already initialised!");
+    error(nrank != VOL_SL, "initHaloExchange [mpi_comm.c]",
+          "The number of processes must be the number of sublattices (%d)!", VOL_SL);
+
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+    for (dir = 0; dir < DIM; dir++)
+    {
+        error((latticeExtent[dir] % 2) != 0, "initHaloExchange [mpi_comm.c]",
+              "The sublattice extents must be even!");
+    }
+
+    /* position of the process in the grid, the last direction runs fastest */
+    for (dir = DIM - 1, r = rank; dir >= 0; dir--)
+    {
+        frac[dir] = latticeExtent_mf[dir] / latticeExtent[dir];
+        coord[dir] = r % frac[dir];
+        r /= frac[dir];
+    }
+
+    /* offsets e in {-1,0,1}^DIM without 0, ordered by the base-3 number of e+1 */
+    for (e = 0, k = 0; k < NOFFSET; e++)
+    {
+        for (dir = DIM - 1, m = e; dir >= 0; dir--)
+        {
+            off[dir] = (m % 3) - 1;
+            m /= 3;
+        }
+        for (dir = 0, b = 0; dir < DIM; dir++)
+            b += (off[dir] != 0);
+        if (b == 0)
+            continue;
+
+        /* the outer layer at offset e is received from the process at e and
+         * the own core slice it needs is sent to the process at -e */
+        for (dir = 0, nbr_recv[k] = 0, nbr_send[k] = 0; dir < DIM; dir++)
+        {
+            nbr_recv[k] = nbr_recv[k] * frac[dir] + (coord[dir] + off[dir] + frac[dir]) % frac[dir];
+            nbr_send[k] = nbr_send[k] * frac[dir] + (coord[dir] - off[dir] + frac[dir]) % frac[dir];
+        }
+
+        for (dir = 0, np = 1; dir < DIM; dir++)
+            np *= (off[dir] == 0) ? latticeExtent[dir] : 1;
+        npt[k] = np;
+        send_idx[k] = malloc(np * sizeof(int));
+        recv_idx[k] = malloc(np * sizeof(int));
+        send_buf[k] = malloc((size_t)(np) * DIM * GF_NREAL * sizeof(double));
+        recv_buf[k] = malloc((size_t)(np) * DIM * GF_NREAL * sizeof(double));
+        error((send_idx[k] == NULL) || (recv_idx[k] == NULL) || (send_buf[k] == NULL) ||
+                  (recv_buf[k] == NULL),
+              "initHaloExchange [mpi_comm.c]", "Unable to allocate buffers!");
+
+        for (dir = 0; dir < DIM; dir++)
+        {
+            if (off[dir] == 0)
+            {
+                lo[dir] = 1;
+                hi[dir] = latticeExtent[dir];
+            }
+            else
+                lo[dir] = hi[dir] = (off[dir] < 0) ? 0 : (latticeExtent[dir] + 1);
+        }
+        regionIndices(lo, hi, recv_idx[k]);
+
+        for (dir = 0; dir < DIM; dir++)
+        {
+            if (off[dir] != 0)
+                lo[dir] = hi[dir] = (off[dir] < 0) ? latticeExtent[dir] : 1;
+        }
+        regionIndices(lo, hi, send_idx[k]);
+        k++;
+    }
+
+    /* the origins of the sublattices are even, so the local parity is the
+     * global one */
+    for (par = 0; par < 2; par++)
+    {
+        cb_nint[par] = 0;
+        for (n = par * (VOL / 2); n < (par + 1) * (VOL / 2); n++)
+        {
+            if (onBoundary(ieo[n]) == 0)
+                cb_list[par][cb_nint[par]++] = i[ieo[n]];
+        }
+        for (n = par * (VOL / 2), nb = cb_nint[par]; n < (par + 1) * (VOL / 2); n++)
+        {
+            if (onBoundary(ieo[n]) == 1)
+                cb_list[par][nb++] = i[ieo[n]];
+        }
+    }
+    init = 1;
+
+    checkpoint("initHaloExchange -- out");
+}
+
+void startHaloExchange(int dir)
+{
+    int k, n, d, d0, d1, c;
+    size_t l;
+    double *b;
+
+    error(init == 0, "startHaloExchange [mpi_comm.c]", "Halo exchange not initialised!");
+    error(pending != 0, "startHaloExchange [mpi_comm.c]", "Halo exchange already pending!");
+
+    d0 = (dir < 0) ? 0 : dir;
+    d1 = (dir < 0) ? DIM : (dir + 1);
+
+    for (k = 0; k < NOFFSET; k++)
+    {
+        MPI_Irecv(recv_buf[k], npt[k] * (d1 - d0) * GF_NREAL, MPI_DOUBLE, nbr_recv[k], k,
+                  MPI_COMM_WORLD, &req[k]);
+    }
+    for (k = 0; k < NOFFSET; k++)
+    {
+        for (n = 0, b = send_buf[k]; n < npt[k]; n++)
+        {
+            for (d = d0; d < d1; d++)
+            {
+                l = gf_offset(gf_link(send_idx[k][n], d));
+                for (c = 0; c < GF_NREAL; c++)
+                    *(b++) = pu[l + (size_t)(c)*GF_STRIDE];
+            }
+        }
+        MPI_Isend(send_buf[k], npt[k] * (d1 - d0) * GF_NREAL, MPI_DOUBLE, nbr_send[k], k,
+                  MPI_COMM_WORLD, &req[NOFFSET + k]);
+    }
+    pending = 1;
+    pending_dir = dir;
+}
+
+void finishHaloExchange(void)
+{
+    int k, n, d, d0, d1, c;
+    size_t l;
+    double *b;
+
+    if (pending == 0)
+        return;
+
+    MPI_Waitall(NOFFSET, req, MPI_STATUSES_IGNORE);
+
+    d0 = (pending_dir < 0) ? 0 : pending_dir;
+    d1 = (pending_dir < 0) ? DIM : (pending_dir + 1);
+    for (k = 0; k < NOFFSET; k++)
+    {
+        for (n = 0, b = recv_buf[k]; n < npt[k]; n++)
+        {
+            for (d = d0; d < d1; d++)
+            {
+                l = gf_offset(gf_link(recv_idx[k][n], d));
+                for (c = 0; c < GF_NREAL; c++)
+                    pu[l + (size_t)(c)*GF_STRIDE] = *(b++);
+            }
+        }
+    }
+
+    MPI_Waitall(NOFFSET, req + NOFFSET, MPI_STATUSES_IGNORE);
+    pending = 0;
+}
+
+void exchangeHalo(void)
+{
+    startHaloExchange(-1);
+    finishHaloExchange();
+}
+
+double mpiGlobalSum(double x)
+{
+    int r;
+    double sum, *all;
+
+    all = malloc(nrank * sizeof(double));
+    error(all == NULL, "mpiGlobalSum [mpi_comm.c]", "Unable to allocate buffers!");
+
+    MPI_Allgather(&x, 1, MPI_DOUBLE, all, 1, MPI_DOUBLE, MPI_COMM_WORLD);
+    for (r = 0, sum = 0.0; r < nrank; r++)
+        sum += all[r];
+    free(all);
+
+    return sum;
+}
+
+int checkerboardList(int par, int **lst)
+{
+    *lst = cb_list[par];
+
+    return cb_nint[par];
+}
+
+#endif
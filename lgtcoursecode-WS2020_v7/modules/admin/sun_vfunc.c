@@ -22,7 +22,7 @@
 * void project_to_su2(su2mat *u)
 *      Projects an approximate SU(2) matrix back to SU(2).
 *
-* void project_gfield_to_sun(sun_mat *u[VOL][DIM])
+* void project_gfield_to_sun(double *u)
 *      Projects approximate SU(2,3) matrices back to SU(2,3),
 *      looping over all matrices in the gaugefield.
 *
@@ -82,17 +82,20 @@ void project_to_su2(su2mat *u)
 }
 
 
-void project_gfield_to_sun(sun_mat *u[VOL][DIM])
+void project_gfield_to_sun(double *u)
 {
    int ii,jj;
+   sun_mat v;
 
    for(ii=0;ii<VOL;ii++)
       for(jj=0;jj<DIM;jj++)
       {
+         gf_get(v,u,ii,jj);
 #if(SUN==2)
-         project_to_su2(u[ii][jj]);
+         project_to_su2(&v);
 #elif(SUN==3)
-         project_to_su3(u[ii][jj]);
+         project_to_su3(&v);
 #endif
+         gf_set(u,ii,jj,v);
       }
 }
@@ -23,14 +23,27 @@
 * int custom_isinf(double x)
 *     Returns true if x is infinite.
 * 
+* int reductionBlocks(void)
+*     Returns the number of blocks of points of the deterministic reductions
+*     (see spin_alg.c). It is set to NRED_BLOCKS_PER_THREAD (see headers.h)
+*     times the maximal number of OpenMP threads at the first call and kept
+*     fixed afterwards, so the first call must not be made inside a
+*     parallel region.
+* 
+* double sumOfBlocks(double *part,int nb)
+*     Returns the sum of part[0..nb-1], computed by pairwise summation in a
+*     fixed order. part is overwritten.
+* 
 *******************************************************************************/
 
 #define UTILS_C
 
 #include <sys/time.h>
 #include <stddef.h>
+#include <omp.h>
+#include "headers.h"
 
-static int time_flag=0;
+static int time_flag=0,nblocks=0;
 /*static time_t ref_time;*/
 struct timeval t1;
 
@@ -109,3 +122,24 @@ void swap(int *a, int *b)
     *a = *b;
     *b = temp;
 }
+
+
+int reductionBlocks(void)
+{
+   if(nblocks==0)
+      nblocks=NRED_BLOCKS_PER_THREAD*omp_get_max_threads();
+
+   return nblocks;
+}
+
+
+double sumOfBlocks(double *part,int nb)
+{
+   int k,m;
+
+   for(m=1;m<nb;m*=2)
+      for(k=0;(k+m)<nb;k+=2*m)
+         part[k]+=part[k+m];
+
+   return part[0];
+}
@@ -10,6 +10,10 @@
 * License (GPL)
 *
 * Includes the routine to apply the Wilson Dirac operator to a fermion field.
+* Each hopping term is computed via the spin projectors (1-+gamma_mu): the
+* upper half of the projected neighbour spinor is multiplied by the link and
+* the lower half is reconstructed from the result (see fermion.h), such that
+* only two SU(N) matrix-vector products per direction are needed.
 * 
 * Externally accessible functions:
 * 
@@ -17,6 +21,36 @@
 * 
 * apply_dirac_wil_conj(sun_wferm *r,sun_wferm *s)
 *
+* double applyNormalWilsonOperator(sun_wferm *r,sun_wferm *s,sun_wferm *w)
+*      Computes r=D^dag*D*s, with D*s stored in the workspace w, and returns
+*      (s,D^dag*D*s)=|D*s|^2 with the normalisation of globalSquareNorm.
+*      The norm is accumulated while D*s is computed, so that no separate
+*      pass over s and r is needed for the scalar product. It is summed
+*      over the blocks of points of spin_alg.c in a fixed order. D^dag is
+*      applied as gamma_5*D*gamma_5, i.e. with the spin projectors of the
+*      two hopping directions interchanged. r, s and w must be different.
+*
+* applyHoppingTermEo(sun_wferm *r,sun_wferm *s,int par)
+*      Applies the hopping term of the Wilson Dirac operator, i.e. the
+*      operator without the diagonal term (4+m), between the points of
+*      parity 1-par and those of parity par. r and s are in even-odd
+*      ordering (see spin_alg.c), only the part of r with parity par is
+*      set and only the part of s with parity 1-par is used. For par=0
+*      this is D_eo, for par=1 D_oe. r and s may be the same field.
+*
+* applyComplexConjHoppingTermEo(sun_wferm *r,sun_wferm *s,int par)
+*      The same for the hopping term of the complex conjugate operator.
+*
+* applyHoppingTermEoMulti(sun_wferm **r,sun_wferm **s,int nrhs,int par)
+* applyComplexConjHoppingTermEoMulti(sun_wferm **r,sun_wferm **s,int nrhs,
+*                                    int par)
+*      As above for the nrhs fields s[0..nrhs-1] at once, r[j] is set to
+*      the hopping term applied to s[j]. The links at each point are
+*      loaded only once for all fields.
+*
+* The loops over the points are distributed over the OpenMP threads with
+* a static partition. Each point of r is written by one thread only.
+*
 *******************************************************************************/
 
 #define DIRAC_WIL_C
@@ -25,185 +59,443 @@
 
 
 
+/* Returns (D*s)(n) for the Wilson Dirac operator D of the gauge field f with
+ * diagonal term fm, s in lexicographic ordering */
+static sun_wferm diracSite(double *f,int n,sun_wferm *s,double fm)
+{
+   int n0,nm0,n1,nm1,n2,nm2,n3,nm3;
+   sun_wferm z1,z2,z3;
+   sun_hferm h1,h2;
+   sun_mat u;
+
+   n0=neib[n][0];
+   n1=neib[n][1];
+   n2=neib[n][2];
+   n3=neib[n][3];
+   nm0=neib[n][DIM];
+   nm1=neib[n][DIM+1];
+   nm2=neib[n][DIM+2];
+   nm3=neib[n][DIM+3];
+
+   sunwferm_zero(z3);
+
+   gf_get(u,f,n,0);
+   sunwferm_proj_m0(h1,s[n0]);
+   sunhferm_sun_mult(h2,u,h1);
+   if(n0<n)
+   {
+      sunwferm_recon_sub_m0(z3,h2);
+   }
+   else
+   {
+      sunwferm_recon_add_m0(z3,h2);
+   }
+
+   gf_get(u,f,nm0,0);
+   sunwferm_proj_p0(h1,s[nm0]);
+   sunhferm_sun_dag_mult(h2,u,h1);
+   if(nm0>n)
+   {
+      sunwferm_recon_sub_p0(z3,h2);
+   }
+   else
+   {
+      sunwferm_recon_add_p0(z3,h2);
+   }
+
+   gf_get(u,f,n,1);
+   sunwferm_proj_m1(h1,s[n1]);
+   sunhferm_sun_mult(h2,u,h1);
+   sunwferm_recon_add_m1(z3,h2);
+
+   gf_get(u,f,nm1,1);
+   sunwferm_proj_p1(h1,s[nm1]);
+   sunhferm_sun_dag_mult(h2,u,h1);
+   sunwferm_recon_add_p1(z3,h2);
+
+   gf_get(u,f,n,2);
+   sunwferm_proj_m2(h1,s[n2]);
+   sunhferm_sun_mult(h2,u,h1);
+   sunwferm_recon_add_m2(z3,h2);
+
+   gf_get(u,f,nm2,2);
+   sunwferm_proj_p2(h1,s[nm2]);
+   sunhferm_sun_dag_mult(h2,u,h1);
+   sunwferm_recon_add_p2(z3,h2);
+
+   gf_get(u,f,n,3);
+   sunwferm_proj_m3(h1,s[n3]);
+   sunhferm_sun_mult(h2,u,h1);
+   sunwferm_recon_add_m3(z3,h2);
+
+   gf_get(u,f,nm3,3);
+   sunwferm_proj_p3(h1,s[nm3]);
+   sunhferm_sun_dag_mult(h2,u,h1);
+   sunwferm_recon_add_p3(z3,h2);
+
+   sunwferm_real_mult(z1,fm,s[n]);
+   sunwferm_real_mult(z2,-0.5,z3);
+   sunwferm_add_single(z1,z2);
+   return z1;
+}
+
+
 void applyWilsonDiracOperator(sun_wferm *r,sun_wferm *s)
 {
 #if(DIM==4)
    int n;
-   int n0,nm0,n1,nm1,n2,nm2,n3,nm3;
    double fm;
-   sun_wferm z1,z2,z3;
 
    fm=(4.+runParams.mass);
 
+#pragma omp parallel for schedule(static)
    for(n=0;n<VOL;n++)
+      r[n]=diracSite(pu,n,s,fm);
+#else
+   error(1,"apply_dirac_wil [dirac_wil.c]","DIM=4 is mandatory!");
+#endif
+}
+
+
+/* The same for D^dag=gamma_5*D*gamma_5, i.e. with the projectors
+ * (1-gamma_mu) and (1+gamma_mu) interchanged */
+static sun_wferm diracSiteConj(double *f,int n,sun_wferm *s,double fm)
+{
+   int n0,nm0,n1,nm1,n2,nm2,n3,nm3;
+   sun_wferm z1,z2,z3;
+   sun_hferm h1,h2;
+   sun_mat u;
+
+   n0=neib[n][0];
+   n1=neib[n][1];
+   n2=neib[n][2];
+   n3=neib[n][3];
+   nm0=neib[n][DIM];
+   nm1=neib[n][DIM+1];
+   nm2=neib[n][DIM+2];
+   nm3=neib[n][DIM+3];
+
+   sunwferm_zero(z3);
+
+   gf_get(u,f,n,0);
+   sunwferm_proj_p0(h1,s[n0]);
+   sunhferm_sun_mult(h2,u,h1);
+   if(n0<n)
+   {
+      sunwferm_recon_sub_p0(z3,h2);
+   }
+   else
    {
-      sunwferm_real_mult(r[n],fm,s[n]);
+      sunwferm_recon_add_p0(z3,h2);
+   }
 
-      n0=neib[n][0];
-      n1=neib[n][1];
-      n2=neib[n][2];
-      n3=neib[n][3];
-      nm0=neib[n][DIM];
-      nm1=neib[n][DIM+1];
-      nm2=neib[n][DIM+2];
-      nm3=neib[n][DIM+3];
+   gf_get(u,f,nm0,0);
+   sunwferm_proj_m0(h1,s[nm0]);
+   sunhferm_sun_dag_mult(h2,u,h1);
+   if(nm0>n)
+   {
+      sunwferm_recon_sub_m0(z3,h2);
+   }
+   else
+   {
+      sunwferm_recon_add_m0(z3,h2);
+   }
 
-      if(n0<n)
-      {
-         sunwferm_sun_mult(z1,*pu[n][0],s[n0]);
-         mul_sunwferm_mg0(z2,z1);
-         sunwferm_add_single(z1,z2);
-         sunwferm_real_mult(z3,-1.,z1);
-      }
-      else
-      {
-         sunwferm_sun_mult(z3,*pu[n][0],s[n0]);
-         mul_sunwferm_mg0(z2,z3);
-         sunwferm_add_single(z3,z2);
-      }
+   gf_get(u,f,n,1);
+   sunwferm_proj_p1(h1,s[n1]);
+   sunhferm_sun_mult(h2,u,h1);
+   sunwferm_recon_add_p1(z3,h2);
+
+   gf_get(u,f,nm1,1);
+   sunwferm_proj_m1(h1,s[nm1]);
+   sunhferm_sun_dag_mult(h2,u,h1);
+   sunwferm_recon_add_m1(z3,h2);
+
+   gf_get(u,f,n,2);
+   sunwferm_proj_p2(h1,s[n2]);
+   sunhferm_sun_mult(h2,u,h1);
+   sunwferm_recon_add_p2(z3,h2);
+
+   gf_get(u,f,nm2,2);
+   sunwferm_proj_m2(h1,s[nm2]);
+   sunhferm_sun_dag_mult(h2,u,h1);
+   sunwferm_recon_add_m2(z3,h2);
+
+   gf_get(u,f,n,3);
+   sunwferm_proj_p3(h1,s[n3]);
+   sunhferm_sun_mult(h2,u,h1);
+   sunwferm_recon_add_p3(z3,h2);
+
+   gf_get(u,f,nm3,3);
+   sunwferm_proj_m3(h1,s[nm3]);
+   sunhferm_sun_dag_mult(h2,u,h1);
+   sunwferm_recon_add_m3(z3,h2);
+
+   sunwferm_real_mult(z1,fm,s[n]);
+   sunwferm_real_mult(z2,-0.5,z3);
+   sunwferm_add_single(z1,z2);
+   return z1;
+}
 
-      if(nm0>n)
-      {
-         sunwferm_sun_dag_mult(z1,*pu[nm0][0],s[nm0]);
-         mul_sunwferm_g0(z2,z1);
-         sunwferm_add_single(z1,z2);
-         sunwferm_real_mult(z2,-1.,z1);
-         sunwferm_add_single(z3,z2);
-      }
-      else
-      {
-         sunwferm_sun_dag_mult(z1,*pu[nm0][0],s[nm0]);
-         sunwferm_add_single(z3,z1);
-         mul_sunwferm_g0(z2,z1);
-         sunwferm_add_single(z3,z2);
-      }
 
-      sunwferm_sun_mult(z1,*pu[n][1],s[n1]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_mg1(z2,z1);
-      sunwferm_add_single(z3,z2);
+void applyComplexConjDiracOperator(sun_wferm *r,sun_wferm *s)
+{
+#if(DIM==4)
+   int n;
+   double fm;
+
+   fm=(4.+runParams.mass);
 
-      sunwferm_sun_dag_mult(z1,*pu[nm1][1],s[nm1]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_g1(z2,z1);
-      sunwferm_add_single(z3,z2);
+#pragma omp parallel for schedule(static)
+   for(n=0;n<VOL;n++)
+      r[n]=diracSiteConj(pu,n,s,fm);
+#else
+   error(1,"apply_dirac_wil [dirac_wil.c]","DIM=4 is mandatory!");
+#endif
+}
 
-      sunwferm_sun_mult(z1,*pu[n][2],s[n2]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_mg2(z2,z1);
-      sunwferm_add_single(z3,z2);
 
-      sunwferm_sun_dag_mult(z1,*pu[nm2][2],s[nm2]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_g2(z2,z1);
-      sunwferm_add_single(z3,z2);
+double applyNormalWilsonOperator(sun_wferm *r,sun_wferm *s,sun_wferm *w)
+{
+#if(DIM==4)
+   int n,b,nb=reductionBlocks();
+   double fm,part[nb];
 
-      sunwferm_sun_mult(z1,*pu[n][3],s[n3]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_mg3(z2,z1);
-      sunwferm_add_single(z3,z2);
+   fm=(4.+runParams.mass);
 
-      sunwferm_sun_dag_mult(z1,*pu[nm3][3],s[nm3]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_g3(z2,z1);
-      sunwferm_add_single(z3,z2);
+#pragma omp parallel for schedule(static)
+   for(b=0;b<nb;b++)
+   {
+      int k,c;
+      double norm;
+      complex *z;
 
-      sunwferm_real_mult(z1,-0.5,z3);
-      sunwferm_add_single(r[n],z1);
+      norm=0.;
+      for(k=red_block_start(b,nb,VOL);k<red_block_start(b+1,nb,VOL);k++)
+      {
+         w[k]=diracSite(pu,k,s,fm);
+         z=(complex*)(w+k);
+         for(c=0;c<DIM*SUN;c++)
+            norm+=z[c].re*z[c].re+z[c].im*z[c].im;
+      }
+      part[b]=norm;
    }
+
+#pragma omp parallel for schedule(static)
+   for(n=0;n<VOL;n++)
+      r[n]=diracSiteConj(pu,n,w,fm);
+
+   return sumOfBlocks(part,nb)/(double)(DIM*SUN*VOL);
 #else
-   error(1,"apply_dirac_wil [dirac_wil.c]","DIM=4 is mandatory!");
+   error(1,"applyNormalWilsonOperator [dirac_wil.c]","DIM=4 is mandatory!");
+   return 0.;
 #endif
 }
 
 
-void applyComplexConjDiracOperator(sun_wferm *r,sun_wferm *s)
+/* Returns the sum of the hopping terms at point n without the factor
+ * -1/2, ul[dir] and ul[DIM+dir] are the links U_dir(n) and U_dir(n-dir)
+ * and s is in even-odd ordering */
+static sun_wferm hoppingSite(int n,sun_mat *ul,sun_wferm *s)
 {
-#if(DIM==4)
-   int n;
    int n0,nm0,n1,nm1,n2,nm2,n3,nm3;
-   double fm;
-   sun_wferm z1,z2,z3;
+   sun_wferm z3;
+   sun_hferm h1,h2;
+
+   n0=neib[n][0];
+   n1=neib[n][1];
+   n2=neib[n][2];
+   n3=neib[n][3];
+   nm0=neib[n][DIM];
+   nm1=neib[n][DIM+1];
+   nm2=neib[n][DIM+2];
+   nm3=neib[n][DIM+3];
+
+   sunwferm_zero(z3);
+
+   sunwferm_proj_m0(h1,s[ipeo[n0]]);
+   sunhferm_sun_mult(h2,ul[0],h1);
+   if(n0<n)
+   {
+      sunwferm_recon_sub_m0(z3,h2);
+   }
+   else
+   {
+      sunwferm_recon_add_m0(z3,h2);
+   }
 
-   fm=(4.+runParams.mass);
+   sunwferm_proj_p0(h1,s[ipeo[nm0]]);
+   sunhferm_sun_dag_mult(h2,ul[DIM],h1);
+   if(nm0>n)
+   {
+      sunwferm_recon_sub_p0(z3,h2);
+   }
+   else
+   {
+      sunwferm_recon_add_p0(z3,h2);
+   }
 
-   for(n=0;n<VOL;n++)
+   sunwferm_proj_m1(h1,s[ipeo[n1]]);
+   sunhferm_sun_mult(h2,ul[1],h1);
+   sunwferm_recon_add_m1(z3,h2);
+
+   sunwferm_proj_p1(h1,s[ipeo[nm1]]);
+   sunhferm_sun_dag_mult(h2,ul[DIM+1],h1);
+   sunwferm_recon_add_p1(z3,h2);
+
+   sunwferm_proj_m2(h1,s[ipeo[n2]]);
+   sunhferm_sun_mult(h2,ul[2],h1);
+   sunwferm_recon_add_m2(z3,h2);
+
+   sunwferm_proj_p2(h1,s[ipeo[nm2]]);
+   sunhferm_sun_dag_mult(h2,ul[DIM+2],h1);
+   sunwferm_recon_add_p2(z3,h2);
+
+   sunwferm_proj_m3(h1,s[ipeo[n3]]);
+   sunhferm_sun_mult(h2,ul[3],h1);
+   sunwferm_recon_add_m3(z3,h2);
+
+   sunwferm_proj_p3(h1,s[ipeo[nm3]]);
+   sunhferm_sun_dag_mult(h2,ul[DIM+3],h1);
+   sunwferm_recon_add_p3(z3,h2);
+   return z3;
+}
+
+
+/* The same for the complex conjugate operator */
+static sun_wferm hoppingSiteConj(int n,sun_mat *ul,sun_wferm *s)
+{
+   int n0,nm0,n1,nm1,n2,nm2,n3,nm3;
+   sun_wferm z3;
+   sun_hferm h1,h2;
+
+   n0=neib[n][0];
+   n1=neib[n][1];
+   n2=neib[n][2];
+   n3=neib[n][3];
+   nm0=neib[n][DIM];
+   nm1=neib[n][DIM+1];
+   nm2=neib[n][DIM+2];
+   nm3=neib[n][DIM+3];
+
+   sunwferm_zero(z3);
+
+   sunwferm_proj_p0(h1,s[ipeo[n0]]);
+   sunhferm_sun_mult(h2,ul[0],h1);
+   if(n0<n)
    {
-      sunwferm_real_mult(r[n],fm,s[n]);
+      sunwferm_recon_sub_p0(z3,h2);
+   }
+   else
+   {
+      sunwferm_recon_add_p0(z3,h2);
+   }
 
-      n0=neib[n][0];
-      n1=neib[n][1];
-      n2=neib[n][2];
-      n3=neib[n][3];
-      nm0=neib[n][DIM];
-      nm1=neib[n][DIM+1];
-      nm2=neib[n][DIM+2];
-      nm3=neib[n][DIM+3];
+   sunwferm_proj_m0(h1,s[ipeo[nm0]]);
+   sunhferm_sun_dag_mult(h2,ul[DIM],h1);
+   if(nm0>n)
+   {
+      sunwferm_recon_sub_m0(z3,h2);
+   }
+   else
+   {
+      sunwferm_recon_add_m0(z3,h2);
+   }
 
-      if(n0<n)
-      {
-         sunwferm_sun_mult(z1,*pu[n][0],s[n0]);
-         mul_sunwferm_g0(z2,z1);
-         sunwferm_add_single(z1,z2);
-        sunwferm_real_mult(z3,-1.,z1);
-      }
-      else
-      {
-         sunwferm_sun_mult(z3,*pu[n][0],s[n0]);
-         mul_sunwferm_g0(z2,z3);
-         sunwferm_add_single(z3,z2);
-      }
+   sunwferm_proj_p1(h1,s[ipeo[n1]]);
+   sunhferm_sun_mult(h2,ul[1],h1);
+   sunwferm_recon_add_p1(z3,h2);
+
+   sunwferm_proj_m1(h1,s[ipeo[nm1]]);
+   sunhferm_sun_dag_mult(h2,ul[DIM+1],h1);
+   sunwferm_recon_add_m1(z3,h2);
+
+   sunwferm_proj_p2(h1,s[ipeo[n2]]);
+   sunhferm_sun_mult(h2,ul[2],h1);
+   sunwferm_recon_add_p2(z3,h2);
+
+   sunwferm_proj_m2(h1,s[ipeo[nm2]]);
+   sunhferm_sun_dag_mult(h2,ul[DIM+2],h1);
+   sunwferm_recon_add_m2(z3,h2);
+
+   sunwferm_proj_p3(h1,s[ipeo[n3]]);
+   sunhferm_sun_mult(h2,ul[3],h1);
+   sunwferm_recon_add_p3(z3,h2);
+
+   sunwferm_proj_m3(h1,s[ipeo[nm3]]);
+   sunhferm_sun_dag_mult(h2,ul[DIM+3],h1);
+   sunwferm_recon_add_m3(z3,h2);
+   return z3;
+}
 
-      if(nm0>n)
+
+void applyHoppingTermEoMulti(sun_wferm **r,sun_wferm **s,int nrhs,int par)
+{
+#if(DIM==4)
+   int k,n,dir,j;
+   sun_wferm z3;
+   sun_mat ul[2*DIM];
+
+#pragma omp parallel for private(n,dir,j,z3,ul) schedule(static)
+   for(k=par*(VOL/2);k<(par+1)*(VOL/2);k++)
+   {
+      n=ieo[k];
+
+      for(dir=0;dir<DIM;dir++)
       {
-         sunwferm_sun_dag_mult(z1,*pu[nm0][0],s[nm0]);
-         mul_sunwferm_mg0(z2,z1);
-         sunwferm_add_single(z1,z2);
-        sunwferm_real_mult(z2,-1.,z1);
-         sunwferm_add_single(z3,z2);
+         gf_get(ul[dir],pu,n,dir);
+         gf_get(ul[DIM+dir],pu,neib[n][DIM+dir],dir);
       }
-      else
+
+      for(j=0;j<nrhs;j++)
       {
-         sunwferm_sun_dag_mult(z1,*pu[nm0][0],s[nm0]);
-         sunwferm_add_single(z3,z1);
-         mul_sunwferm_mg0(z2,z1);
-         sunwferm_add_single(z3,z2);
+         z3=hoppingSite(n,ul,s[j]);
+         sunwferm_real_mult(r[j][k],-0.5,z3);
       }
+   }
+#else
+   error(1,"applyHoppingTermEoMulti [dirac_wil.c]","DIM=4 is mandatory!");
+#endif
+}
 
-      sunwferm_sun_mult(z1,*pu[n][1],s[n1]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_g1(z2,z1);
-      sunwferm_add_single(z3,z2);
 
-      sunwferm_sun_dag_mult(z1,*pu[nm1][1],s[nm1]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_mg1(z2,z1);
-      sunwferm_add_single(z3,z2);
+void applyHoppingTermEo(sun_wferm *r,sun_wferm *s,int par)
+{
+   applyHoppingTermEoMulti(&r,&s,1,par);
+}
 
-      sunwferm_sun_mult(z1,*pu[n][2],s[n2]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_g2(z2,z1);
-      sunwferm_add_single(z3,z2);
 
-      sunwferm_sun_dag_mult(z1,*pu[nm2][2],s[nm2]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_mg2(z2,z1);
-      sunwferm_add_single(z3,z2);
+void applyComplexConjHoppingTermEoMulti(sun_wferm **r,sun_wferm **s,int nrhs,int par)
+{
+#if(DIM==4)
+   int k,n,dir,j;
+   sun_wferm z3;
+   sun_mat ul[2*DIM];
 
-      sunwferm_sun_mult(z1,*pu[n][3],s[n3]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_g3(z2,z1);
-      sunwferm_add_single(z3,z2);
+#pragma omp parallel for private(n,dir,j,z3,ul) schedule(static)
+   for(k=par*(VOL/2);k<(par+1)*(VOL/2);k++)
+   {
+      n=ieo[k];
 
-      sunwferm_sun_dag_mult(z1,*pu[nm3][3],s[nm3]);
-      sunwferm_add_single(z3,z1);
-      mul_sunwferm_mg3(z2,z1);
-      sunwferm_add_single(z3,z2);
+      for(dir=0;dir<DIM;dir++)
+      {
+         gf_get(ul[dir],pu,n,dir);
+         gf_get(ul[DIM+dir],pu,neib[n][DIM+dir],dir);
+      }
 
-      sunwferm_real_mult(z1,-0.5,z3);
-      sunwferm_add_single(r[n],z1);
+      for(j=0;j<nrhs;j++)
+      {
+         z3=hoppingSiteConj(n,ul,s[j]);
+         sunwferm_real_mult(r[j][k],-0.5,z3);
+      }
    }
 #else
-   error(1,"apply_dirac_wil [dirac_wil.c]","DIM=4 is mandatory!");
+   error(1,"applyComplexConjHoppingTermEoMulti [dirac_wil.c]","DIM=4 is mandatory!");
 #endif
 }
+
+
+void applyComplexConjHoppingTermEo(sun_wferm *r,sun_wferm *s,int par)
+{
+   applyComplexConjHoppingTermEoMulti(&r,&s,1,par);
+}
@@ -35,89 +35,188 @@
 *         Returns the real part of the scalar product (f2,f1) normalised
 *         to 1 when f2 and f1 are unit spinors.
 *
+* void reorderSpinorsToEvenOdd(sun_wferm *f2,sun_wferm *f1)
+*      Copies the spinor f1 in lexicographic ordering into f2 in even-odd
+*      ordering, i.e. f2[k]=f1[ieo[k]]. The even points are stored in
+*      f2[0..VOL/2-1] and the odd points in f2[VOL/2..VOL-1].
+*
+* void reorderSpinorsToLexicographic(sun_wferm *f2,sun_wferm *f1)
+*      Inverse of reorderSpinorsToEvenOdd.
+*
+* void copySpinorsHalf(sun_wferm *f2,sun_wferm *f1)
+* void multiplyByRealHalf(sun_wferm *f2,double a,sun_wferm *f1)
+* void multiplyByRealAndSumHalf(sun_wferm *f3,sun_wferm *f2,double a,sun_wferm *f1)
+* double globalSquareNormHalf(sun_wferm *f)
+* double realPartOfScalarProdHalf(sun_wferm *f2,sun_wferm *f1)
+*      As the functions above (multiplyByRealHalf computes f2=a*f1), but
+*      acting on the VOL/2 points of one parity of spinors in even-odd
+*      ordering. The even (odd) part of f is passed as f (f+VOL/2). The
+*      normalisation is the one of the full spinor, so that the norms of
+*      the two parts add up to the norm of the full spinor.
+*
+* All loops are distributed over the OpenMP threads with a static
+* partition. The reductions first sum the points of each of the
+* reductionBlocks() blocks of red_block_start (see headers.h and utils.c)
+* and then add up the block sums with sumOfBlocks. The results are
+* therefore bitwise independent of the number of threads the blocks are
+* distributed over.
+*
 *******************************************************************************/
 
 #define SPIN_ALG_C
 
 #include"modules.h"
 
+/* number of reals of nvol points of a spinor field */
+#define NREAL(nvol) (2*DIM*SUN*(nvol))
+
+
+
+/* Returns the sum of |f[k]|^2 over the points k=0,..,nvol-1, not normalised */
+static double squareNormOfPoints(sun_wferm *f,int nvol)
+{
+   int b,nb=reductionBlocks();
+   double part[nb];
+
+#pragma omp parallel for schedule(static)
+   for(b=0;b<nb;b++)
+   {
+      double norm;
+      complex *s,*sf;
+
+      s=(complex*)(f+red_block_start(b,nb,nvol));
+      sf=(complex*)(f+red_block_start(b+1,nb,nvol));
+      for(norm=0.;s<sf;s+=1)
+         norm+=(*s).re*(*s).re+(*s).im*(*s).im;
+      part[b]=norm;
+   }
+
+   return sumOfBlocks(part,nb);
+}
+
+
+/* Returns the real part of the sum of (f2[k],f1[k]) over the points
+ * k=0,..,nvol-1, not normalised */
+static double realScalarProdOfPoints(sun_wferm *f2,sun_wferm *f1,int nvol)
+{
+   int b,nb=reductionBlocks();
+   double part[nb];
+
+#pragma omp parallel for schedule(static)
+   for(b=0;b<nb;b++)
+   {
+      double prod,z;
+      complex *s1,*s2,*sf;
+
+      s1=(complex*)(f1+red_block_start(b,nb,nvol));
+      s2=(complex*)(f2+red_block_start(b,nb,nvol));
+      sf=(complex*)(f1+red_block_start(b+1,nb,nvol));
+      for(prod=0.;s1<sf;s1+=1,s2+=1)
+      {
+         compl_mult_sn_re(z,*s2,*s1);
+         prod+=z;
+      }
+      part[b]=prod;
+   }
+
+   return sumOfBlocks(part,nb);
+}
 
 
 void setAllSpinorsToZero(sun_wferm *f)
 {
-    double *s,*sf;
-    s=(double*)(f);
-    sf=s+2*DIM*SUN*VOL;
-    for(;s<sf;s+=1)
-       *s=0.;
+   int i;
+   double *s;
+   s=(double*)(f);
+#pragma omp parallel for schedule(static)
+   for(i=0;i<NREAL(VOL);i++)
+      s[i]=0.;
 }
 
 
 void copySpinors(sun_wferm *f2,sun_wferm *f1)
 {
-   double *s1,*s2,*sf;
+   int i;
+   double *s1,*s2;
    s1=(double*)(f1);
    s2=(double*)(f2);
-   sf=s1+2*DIM*SUN*VOL;
-   for(;s1<sf;s1+=1,s2+=1)
-      *s2=*s1;
+#pragma omp parallel for schedule(static)
+   for(i=0;i<NREAL(VOL);i++)
+      s2[i]=s1[i];
 }
 
 
 void multiplyByRealAndSum(sun_wferm *f3,sun_wferm *f2,double a,sun_wferm *f1)
 {
-   double *s1,*s2,*s3,*sf;
+   int i;
+   double *s1,*s2,*s3;
    s1=(double*)(f1);
    s2=(double*)(f2);
    s3=(double*)(f3);
-   sf=s1+2*DIM*SUN*VOL;
-   for(;s1<sf;s1+=1,s2+=1,s3+=1)
-      *s3=*s2+a*(*s1);
+#pragma omp parallel for schedule(static)
+   for(i=0;i<NREAL(VOL);i++)
+      s3[i]=s2[i]+a*s1[i];
 }
 
 
 double globalSquareNorm(sun_wferm *f)
 {
-   double norm;
-   complex *s,*sf;
-   s=(complex*)(f);
-   sf=s+DIM*SUN*VOL;
-   for(norm=0.;s<sf;s+=1)
-      norm+=(*s).re*(*s).re+(*s).im*(*s).im;
-   return norm/(double)(DIM*SUN*VOL);
+   return squareNormOfPoints(f,VOL)/(double)(DIM*SUN*VOL);
 }
 
 
 double globalSum(sun_wferm *f)
 {
-   double sum;
-   complex *s,*sf;
-   s=(complex*)(f);
-   sf=s+DIM*SUN*VOL;
-   for(sum=0.;s<sf;s+=1)
+   int b,nb=reductionBlocks();
+   double part[nb];
+
+#pragma omp parallel for schedule(static)
+   for(b=0;b<nb;b++)
    {
-      sum+=(*s).re;
-      sum+=(*s).im;
+      double sum;
+      complex *s,*sf;
+
+      s=(complex*)(f+red_block_start(b,nb,VOL));
+      sf=(complex*)(f+red_block_start(b+1,nb,VOL));
+      for(sum=0.;s<sf;s+=1)
+      {
+         sum+=(*s).re;
+         sum+=(*s).im;
+      }
+      part[b]=sum;
    }
-   return sum/(double)(DIM*SUN*VOL);
+
+   return sumOfBlocks(part,nb)/(double)(DIM*SUN*VOL);
 }
 
 
 complex scalarProd(sun_wferm *f2,sun_wferm *f1)
 {
-   complex z,prod;
-   complex *s1,*s2,*sf;
+   int b,nb=reductionBlocks();
+   double pre[nb],pim[nb];
+   complex prod;
 
-   s1=(complex*)(f1);
-   s2=(complex*)(f2);
-   sf=s1+4*SUN*VOL;
-   prod.re=0.;
-   prod.im=0.;
-   for(;s1<sf;s1+=1,s2+=1)
+#pragma omp parallel for schedule(static)
+   for(b=0;b<nb;b++)
    {
-      compl_mult_sn(z,*s2,*s1);
-      compl_selfadd(prod,z);
+      complex z,sum;
+      complex *s1,*s2,*sf;
+
+      s1=(complex*)(f1+red_block_start(b,nb,VOL));
+      s2=(complex*)(f2+red_block_start(b,nb,VOL));
+      sf=(complex*)(f1+red_block_start(b+1,nb,VOL));
+      sum.re=0.;
+      sum.im=0.;
+      for(;s1<sf;s1+=1,s2+=1)
+      {
+         compl_mult_sn(z,*s2,*s1);
+         compl_selfadd(sum,z);
+      }
+      pre[b]=sum.re;
+      pim[b]=sum.im;
    }
+   prod.re=sumOfBlocks(pre,nb);
+   prod.im=sumOfBlocks(pim,nb);
    compl_realdiv_single(prod,(double)(4*SUN*VOL));
 
    return prod;
@@ -126,17 +225,72 @@ complex scalarProd(sun_wferm *f2,sun_wferm *f1)
 
 double realPartOfScalarProd(sun_wferm *f2,sun_wferm *f1)
 {
-   double prod,z;
-   complex *s1,*s2,*sf;
+   return realScalarProdOfPoints(f2,f1,VOL)/(double)(DIM*SUN*VOL);
+}
 
-   s1=(complex*)(f1);
-   s2=(complex*)(f2);
-   sf=s1+4*SUN*VOL;
-   for(prod=0.;s1<sf;s1+=1,s2+=1)
-   {
-      compl_mult_sn_re(z,*s2,*s1);
-      prod+=z;
-   }
 
-   return prod/(double)(DIM*SUN*VOL);
+void reorderSpinorsToEvenOdd(sun_wferm *f2,sun_wferm *f1)
+{
+   int k;
+#pragma omp parallel for schedule(static)
+   for(k=0;k<VOL;k++)
+      f2[k]=f1[ieo[k]];
+}
+
+
+void reorderSpinorsToLexicographic(sun_wferm *f2,sun_wferm *f1)
+{
+   int k;
+#pragma omp parallel for schedule(static)
+   for(k=0;k<VOL;k++)
+      f2[ieo[k]]=f1[k];
+}
+
+
+void copySpinorsHalf(sun_wferm *f2,sun_wferm *f1)
+{
+   int i;
+   double *s1,*s2;
+   s1=(double*)(f1);
+   s2=(double*)(f2);
+#pragma omp parallel for schedule(static)
+   for(i=0;i<NREAL(VOL/2);i++)
+      s2[i]=s1[i];
+}
+
+
+void multiplyByRealHalf(sun_wferm *f2,double a,sun_wferm *f1)
+{
+   int i;
+   double *s1,*s2;
+   s1=(double*)(f1);
+   s2=(double*)(f2);
+#pragma omp parallel for schedule(static)
+   for(i=0;i<NREAL(VOL/2);i++)
+      s2[i]=a*s1[i];
+}
+
+
+void multiplyByRealAndSumHalf(sun_wferm *f3,sun_wferm *f2,double a,sun_wferm *f1)
+{
+   int i;
+   double *s1,*s2,*s3;
+   s1=(double*)(f1);
+   s2=(double*)(f2);
+   s3=(double*)(f3);
+#pragma omp parallel for schedule(static)
+   for(i=0;i<NREAL(VOL/2);i++)
+      s3[i]=s2[i]+a*s1[i];
+}
+
+
+double globalSquareNormHalf(sun_wferm *f)
+{
+   return squareNormOfPoints(f,VOL/2)/(double)(DIM*SUN*VOL);
+}
+
+
+double realPartOfScalarProdHalf(sun_wferm *f2,sun_wferm *f1)
+{
+   return realScalarProdOfPoints(f2,f1,VOL/2)/(double)(DIM*SUN*VOL);
 }
@@ -0,0 +1,457 @@
+
+/*******************************************************************************
+*
+* File solv_bcg.c
+*
+* This software is distributed under the terms of the GNU General Public
+* License (GPL)
+*
+* Includes the block conjugate gradient for the Wilson Dirac operator with
+* several right-hand sides.
+*
+* Externally accessible functions:
+*
+* void allocateFermionFieldsForBlockCG(int nmrhs)
+*     Allocates the fields for the block CG with up to nmrhs right-hand
+*     sides.
+*
+* void deallocateFermionFieldsForBlockCG(void)
+*     Frees the fields allocated by allocateFermionFieldsForBlockCG.
+*
+* int bcg_eo(sun_wferm **x,sun_wferm **b,int nrhs,double eps,int nmax,
+*            int *niter)
+*     Solves D*x[j]=b[j], j=0,..,nrhs-1, for the Wilson Dirac operator D
+*     with the even-odd preconditioned block conjugate gradient, starting
+*     from the initial guesses x[j]. As in cg_eo the normal equations of
+*     the Schur complement A=fm-D_eo*D_oe/fm are solved on the even points
+*     and the odd points are rebuilt, but the search directions of all
+*     right-hand sides span a common block Krylov space and the operator
+*     is applied to all of them in one sweep over the links. Converged
+*     right-hand sides are removed from the block. Each solution is then
+*     checked with the stopping criterion of cg_eo and refined with cg_eo
+*     if necessary, which requires allocateFermionFieldsForCG to have been
+*     called. On return niter[j] contains the number of iterations for the
+*     right-hand side j, or -1 and -2 as returned by cg. The function
+*     returns the number of block iterations.
+*
+* The block CG follows D.P. O'Leary, Lin. Alg. Appl. 29 (1980) 293. With
+* the residuals R and the search directions P of the active right-hand
+* sides as columns and Q=A^dag*A*P, one iteration is
+*
+*   alpha=(P^dag*Q)^(-1)*(R^dag*R),    X=X+P*alpha,    R'=R-Q*alpha,
+*   beta=(R^dag*R)^(-1)*(R'^dag*R'),   P=R'+P*beta,
+*
+* where the small hermitian systems are solved by a Cholesky decomposition.
+*
+*******************************************************************************/
+
+#define SOLV_BCG_C
+
+#include<stdlib.h>
+#include<float.h>
+#include"headers.h"
+#include"modules.h"
+
+static int init=0,nmrhs;
+static int *act,*kp;
+static double *tol;
+static complex *pq,*rr,*rrn,*alp,*gb;
+static sun_wferm **xe,**be,**r,**p,**q,**t;
+static sun_wferm **pa,**qa,**ta,**ra,**xa;
+
+
+
+static void allocateFieldArray(sun_wferm ***f,int n)
+{
+   int j;
+
+   (*f)=malloc(n*sizeof(sun_wferm*));
+   error((*f)==NULL,"allocateFieldArray [solv_bcg.c]",
+         "Unable to allocate field array!");
+   for(j=0;j<n;j++)
+      allocateFermionField((*f)+j);
+}
+
+
+static void deallocateFieldArray(sun_wferm ***f,int n)
+{
+   int j;
+
+   for(j=0;j<n;j++)
+      deallocateFermionField((*f)+j);
+   free(*f);
+}
+
+
+void allocateFermionFieldsForBlockCG(int n)
+{
+   error(init!=0,"allocateFermionFieldsForBlockCG [solv_bcg.c]",
+         "Block CG already initialised!");
+   error(n<1,"allocateFermionFieldsForBlockCG [solv_bcg.c]",
+         "Number of right-hand sides must be positive!");
+
+   nmrhs=n;
+   allocateFieldArray(&xe,n);
+   allocateFieldArray(&be,n);
+   allocateFieldArray(&r,n);
+   allocateFieldArray(&p,n);
+   allocateFieldArray(&q,n);
+   allocateFieldArray(&t,n);
+
+   pa=malloc(5*n*sizeof(sun_wferm*));
+   act=malloc(2*n*sizeof(int));
+   tol=malloc(n*sizeof(double));
+   pq=malloc(4*n*n*sizeof(complex));
+   gb=malloc(reductionBlocks()*n*n*sizeof(complex));
+   error((pa==NULL)||(act==NULL)||(tol==NULL)||(pq==NULL)||(gb==NULL),
+         "allocateFermionFieldsForBlockCG [solv_bcg.c]",
+         "Unable to allocate auxiliary arrays!");
+   kp=act+n;
+   qa=pa+n;
+   ta=qa+n;
+   ra=ta+n;
+   xa=ra+n;
+   rr=pq+n*n;
+   rrn=rr+n*n;
+   alp=rrn+n*n;
+   init=1;
+}
+
+
+void deallocateFermionFieldsForBlockCG(void)
+{
+   error(init==0,"deallocateFermionFieldsForBlockCG [solv_bcg.c]",
+         "Block CG not initialised!");
+
+   deallocateFieldArray(&xe,nmrhs);
+   deallocateFieldArray(&be,nmrhs);
+   deallocateFieldArray(&r,nmrhs);
+   deallocateFieldArray(&p,nmrhs);
+   deallocateFieldArray(&q,nmrhs);
+   deallocateFieldArray(&t,nmrhs);
+   free(pa);
+   free(act);
+   free(tol);
+   free(pq);
+   free(gb);
+   init=0;
+}
+
+
+/* r[j]=A*s[j] (conj==0) or r[j]=A^dag*s[j] (conj==1), j=0,..,n-1, for the
+ * Schur complement A=fm-D_eo*D_oe/fm on the even points */
+static void applySchurOperatorMulti(sun_wferm **r,sun_wferm **s,int n,
+                                    int conj,double fm)
+{
+   int j;
+
+   if(conj==0)
+   {
+      applyHoppingTermEoMulti(r,s,n,1);
+      applyHoppingTermEoMulti(r,r,n,0);
+   }
+   else
+   {
+      applyComplexConjHoppingTermEoMulti(r,s,n,1);
+      applyComplexConjHoppingTermEoMulti(r,r,n,0);
+   }
+   for(j=0;j<n;j++)
+   {
+      multiplyByRealAndSumHalf(r[j],s[j],-1./(fm*fm),r[j]);
+      multiplyByRealHalf(r[j],fm,r[j]);
+   }
+}
+
+
+/* g[i*n+k]=(v[i],w[k]) on the even points, normalised as realPartOfScalarProd.
+ * With v==w only i<=k is computed and g is completed as hermitian matrix.
+ * The sums are taken over the blocks of points of spin_alg.c and added in a
+ * fixed order */
+static void blockScalarProd(complex *g,sun_wferm **v,sun_wferm **w,int n)
+{
+   int i,k,b,nb=reductionBlocks();
+   double pre[nb],pim[nb];
+
+#pragma omp parallel for private(i,k) schedule(static)
+   for(b=0;b<nb;b++)
+   {
+      int c;
+      complex z,*vi,*wk,*gl;
+
+      gl=gb+b*n*n;
+      for(i=0;i<n*n;i++)
+      {
+         gl[i].re=0.;
+         gl[i].im=0.;
+      }
+
+      for(c=DIM*SUN*red_block_start(b,nb,VOL/2);c<DIM*SUN*red_block_start(b+1,nb,VOL/2);c++)
+      {
+         for(i=0;i<n;i++)
+         {
+            vi=(complex*)(v[i])+c;
+            for(k=((v==w)?i:0);k<n;k++)
+            {
+               wk=(complex*)(w[k])+c;
+               compl_mult_sn(z,*vi,*wk);
+               compl_selfadd(gl[i*n+k],z);
+            }
+         }
+      }
+   }
+
+   for(i=0;i<n;i++)
+   {
+      for(k=((v==w)?i:0);k<n;k++)
+      {
+         for(b=0;b<nb;b++)
+         {
+            pre[b]=gb[b*n*n+i*n+k].re;
+            pim[b]=gb[b*n*n+i*n+k].im;
+         }
+         g[i*n+k].re=sumOfBlocks(pre,nb);
+         g[i*n+k].im=sumOfBlocks(pim,nb);
+         compl_realdiv_single(g[i*n+k],(double)(DIM*SUN*VOL));
+         if(v==w)
+         {
+            g[k*n+i].re=g[i*n+k].re;
+            g[k*n+i].im=-g[i*n+k].im;
+         }
+      }
+   }
+}
+
+
+/* y[k]=z[k]+sgn*sum_i v[i]*a[i*n+k] on the even points. y may be equal to z */
+static void blockCombine(sun_wferm **y,sun_wferm **z,double sgn,
+                         complex *a,sun_wferm **v,int n)
+{
+   int i,k,c,nc;
+   complex w,s,*vi;
+
+   nc=DIM*SUN*(VOL/2);
+#pragma omp parallel for private(i,k,w,s,vi) schedule(static)
+   for(c=0;c<nc;c++)
+   {
+      for(k=0;k<n;k++)
+      {
+         s.re=0.;
+         s.im=0.;
+         for(i=0;i<n;i++)
+         {
+            vi=(complex*)(v[i])+c;
+            compl_mult(w,*vi,a[i*n+k]);
+            compl_selfadd(s,w);
+         }
+         ((complex*)(y[k]))[c].re=((complex*)(z[k]))[c].re+sgn*s.re;
+         ((complex*)(y[k]))[c].im=((complex*)(z[k]))[c].im+sgn*s.im;
+      }
+   }
+}
+
+
+/* Solves a*x=b for the hermitian positive definite n x n matrix a and the
+ * n x n matrix b. a is overwritten by its Cholesky factor, b by x.
+ * Returns 1 if a is not positive definite and 0 otherwise */
+static int choleskySolve(complex *a,complex *b,int n)
+{
+   int i,j,k,c;
+   double d;
+   complex z,s;
+
+   for(j=0;j<n;j++)
+   {
+      d=a[j*n+j].re;
+      for(k=0;k<j;k++)
+         d-=a[j*n+k].re*a[j*n+k].re+a[j*n+k].im*a[j*n+k].im;
+      if(d<=DBL_EPSILON*a[j*n+j].re)
+         return 1;
+      d=sqrt(d);
+      a[j*n+j].re=d;
+      a[j*n+j].im=0.;
+
+      for(i=j+1;i<n;i++)
+      {
+         s=a[i*n+j];
+         for(k=0;k<j;k++)
+         {
+            compl_mult_sn(z,a[j*n+k],a[i*n+k]);
+            compl_selfsub(s,z);
+         }
+         compl_realdiv_single(s,d);
+         a[i*n+j]=s;
+      }
+   }
+
+   for(c=0;c<n;c++)
+   {
+      for(i=0;i<n;i++)
+      {
+         s=b[i*n+c];
+         for(k=0;k<i;k++)
+         {
+            compl_mult(z,a[i*n+k],b[k*n+c]);
+            compl_selfsub(s,z);
+         }
+         compl_realdiv_single(s,a[i*n+i].re);
+         b[i*n+c]=s;
+      }
+      for(i=n-1;i>=0;i--)
+      {
+         s=b[i*n+c];
+         for(k=i+1;k<n;k++)
+         {
+            compl_mult_sn(z,a[k*n+i],b[k*n+c]);
+            compl_selfsub(s,z);
+         }
+         compl_realdiv_single(s,a[i*n+i].re);
+         b[i*n+c]=s;
+      }
+   }
+
+   return 0;
+}
+
+
+/* Points pa,qa,ta,ra,xa to the fields of the na active right-hand sides */
+static void setActiveFields(int na)
+{
+   int k;
+
+   for(k=0;k<na;k++)
+   {
+      pa[k]=p[act[k]];
+      qa[k]=q[act[k]];
+      ta[k]=t[act[k]];
+      ra[k]=r[act[k]];
+      xa[k]=xe[act[k]];
+   }
+}
+
+
+
+int bcg_eo(sun_wferm **x,sun_wferm **b,int nrhs,double eps,int nmax,
+           int *niter)
+{
+   int i,j,k,na,nn,it,n;
+   double fm,xi;
+   sun_wferm *sw;
+
+   error(init==0,"bcg_eo [solv_bcg.c]","Block CG not initialised!");
+   error((nrhs<1)||(nrhs>nmrhs),"bcg_eo [solv_bcg.c]",
+         "Number of right-hand sides out of range!");
+
+   fm=(4.+runParams.mass);
+
+   for(j=0;j<nrhs;j++)
+   {
+      applyComplexConjDiracOperator(t[j],b[j]);
+      tol[j]=eps*sqrt(globalSquareNorm(t[j]));
+      reorderSpinorsToEvenOdd(xe[j],x[j]);
+      reorderSpinorsToEvenOdd(be[j],b[j]);
+   }
+   applyHoppingTermEoMulti(t,be,nrhs,0);
+   for(j=0;j<nrhs;j++)
+      multiplyByRealAndSumHalf(be[j],be[j],-1./fm,t[j]);
+
+   applySchurOperatorMulti(t,xe,nrhs,0,fm);
+   for(j=0;j<nrhs;j++)
+      multiplyByRealAndSumHalf(t[j],be[j],-1.,t[j]);
+   applySchurOperatorMulti(r,t,nrhs,1,fm);
+
+   for(j=0,na=0;j<nrhs;j++)
+   {
+      niter[j]=-1;
+      if(sqrt(globalSquareNormHalf(r[j]))<tol[j])
+         niter[j]=0;
+      else
+      {
+         copySpinorsHalf(p[j],r[j]);
+         act[na++]=j;
+      }
+   }
+   setActiveFields(na);
+   blockScalarProd(rr,ra,ra,na);
+
+   for(it=0;(it<nmax)&&(na>0);it++)
+   {
+      applySchurOperatorMulti(ta,pa,na,0,fm);
+      applySchurOperatorMulti(qa,ta,na,1,fm);
+
+      blockScalarProd(pq,pa,qa,na);
+      for(i=0;i<na*na;i++)
+         alp[i]=rr[i];
+      if(choleskySolve(pq,alp,na)!=0)
+      {
+         for(k=0;k<na;k++)
+            niter[act[k]]=-2;
+         na=0;
+         break;
+      }
+      blockCombine(xa,xa,1.,alp,pa,na);
+      blockCombine(ra,ra,-1.,alp,qa,na);
+
+      blockScalarProd(rrn,ra,ra,na);
+      for(i=0;i<na*na;i++)
+         alp[i]=rrn[i];
+      if(choleskySolve(rr,alp,na)!=0)
+      {
+         for(k=0;k<na;k++)
+            niter[act[k]]=-2;
+         na=0;
+         break;
+      }
+      blockCombine(ta,ra,1.,alp,pa,na);
+      for(k=0;k<na;k++)
+      {
+         sw=p[act[k]];
+         p[act[k]]=t[act[k]];
+         t[act[k]]=sw;
+      }
+
+      /* converged right-hand sides are removed from the block */
+      for(k=0,nn=0;k<na;k++)
+      {
+         j=act[k];
+         xi=globalSquareNormHalf(xe[j]);
+         if((100.0*DBL_EPSILON*sqrt(xi))>tol[j])
+            niter[j]=-2;
+         else if(sqrt(rrn[k*na+k].re)<tol[j])
+            niter[j]=it+1;
+         else
+            kp[nn++]=k;
+      }
+      for(i=0;i<nn;i++)
+         for(k=0;k<nn;k++)
+            rr[i*nn+k]=rrn[kp[i]*na+kp[k]];
+      for(k=0;k<nn;k++)
+         act[k]=act[kp[k]];
+      na=nn;
+      setActiveFields(na);
+   }
+
+   applyHoppingTermEoMulti(xe,xe,nrhs,1);
+   for(j=0;j<nrhs;j++)
+   {
+      multiplyByRealAndSumHalf(xe[j]+VOL/2,be[j]+VOL/2,-1.,xe[j]+VOL/2);
+      multiplyByRealHalf(xe[j]+VOL/2,1./fm,xe[j]+VOL/2);
+      reorderSpinorsToLexicographic(x[j],xe[j]);
+   }
+
+   for(j=0;j<nrhs;j++)
+   {
+      if(niter[j]<0)
+         continue;
+
+      applyWilsonDiracOperator(q[j],x[j]);
+      multiplyByRealAndSum(q[j],b[j],-1.,q[j]);
+      applyComplexConjDiracOperator(t[j],q[j]);
+      if(sqrt(globalSquareNorm(t[j]))>=tol[j])
+      {
+         n=cg_eo(x[j],b[j],eps,nmax-niter[j]);
+         niter[j]=(n<0)?n:(niter[j]+n);
+      }
+   }
+
+   return it;
+}
@@ -13,7 +13,28 @@
 * 
 * Externally accessible functions:
 * 
-* 
+* int cg(sun_wferm *x,void (*A)(sun_wferm *r,sun_wferm *s),
+*        void (*Ad)(sun_wferm *r,sun_wferm *s),sun_wferm *b,
+*        double eps,int nmax)
+*     Solves Ad*A*x=b with the conjugate gradient, starting from the
+*     initial guess x. Returns the number of iterations, -1 if the
+*     solver did not converge within nmax iterations and -2 if the
+*     required precision eps*|b| can not be reached. If A and Ad are
+*     applyWilsonDiracOperator and applyComplexConjDiracOperator, the
+*     fused normal operator applyNormalWilsonOperator (see dirac_wil.c)
+*     is used, which returns (p,Ad*A*p) along with Ad*A*p.
+*
+* int cg_eo(sun_wferm *x,sun_wferm *b,double eps,int nmax)
+*     Solves D*x=b for the Wilson Dirac operator D with the even-odd
+*     preconditioned conjugate gradient, starting from the initial guess
+*     x. With the hopping terms D_eo and D_oe and the diagonal term
+*     fm=4+m, the Schur complement A=fm-D_eo*D_oe/fm is inverted on the
+*     even points via the normal equations and the odd points are
+*     rebuilt from x_o=(b_o-D_oe*x_e)/fm. The solver stops once the
+*     residual |D^dag*(b-D*x)| of the full operator is below eps*|D^dag*b|,
+*     i.e. with the same stopping criterion as cg for D^dag*D*x=D^dag*b.
+*     x and b are in lexicographic ordering. Returns the number of
+*     iterations or -1 and -2 as cg.
 * 
 *******************************************************************************/
 
@@ -24,7 +45,7 @@
 #include"modules.h"
 
 static int init=0;
-static sun_wferm *z1,*z2,*p,*r;
+static sun_wferm *z1,*z2,*p,*r,*xe,*be;
 
 
 
@@ -35,6 +56,8 @@ void allocateFermionFieldsForCG(void)
    allocateFermionField(&z2);
    allocateFermionField(&p);
    allocateFermionField(&r);
+   allocateFermionField(&xe);
+   allocateFermionField(&be);
    init=1;
 }
 
@@ -47,6 +70,8 @@ void deallocateFermionFieldsForCG(void)
    deallocateFermionField(&z2);
    deallocateFermionField(&p);
    deallocateFermionField(&r);
+   deallocateFermionField(&xe);
+   deallocateFermionField(&be);
    init=0;
 }
 
@@ -56,15 +81,21 @@ int cg(sun_wferm *x,void (*A)(sun_wferm *r,sun_wferm *s),
        void (*Ad)(sun_wferm *r,sun_wferm *s),sun_wferm *b,
        double eps,int nmax)
 {
-   int n;
+   int n,wil;
    double tol,alp,xi1,xi2;
 
    error(init==0,"cg [solv_cg.c]","CG not initialised!");
 
+   wil=((A==applyWilsonDiracOperator)&&(Ad==applyComplexConjDiracOperator));
    tol=eps*sqrt(globalSquareNorm(b));
 
-   (*A)(z2,x);
-   (*Ad)(z1,z2);
+   if(wil)
+      applyNormalWilsonOperator(z1,x,z2);
+   else
+   {
+      (*A)(z2,x);
+      (*Ad)(z1,z2);
+   }
    multiplyByRealAndSum(r,b,-1.,z1);
    xi1=globalSquareNorm(r);
    if(sqrt(xi1)<tol)
@@ -73,10 +104,14 @@ int cg(sun_wferm *x,void (*A)(sun_wferm *r,sun_wferm *s),
 
    for(n=0;n<nmax;n++)
    {
-      (*A)(z2,p);
-      (*Ad)(z1,z2);
-
-      xi2=realPartOfScalarProd(p,z1);
+      if(wil)
+         xi2=applyNormalWilsonOperator(z1,p,z2);
+      else
+      {
+         (*A)(z2,p);
+         (*Ad)(z1,z2);
+         xi2=realPartOfScalarProd(p,z1);
+      }
       alp=xi1/xi2;
       multiplyByRealAndSum(x,x,alp,p);
       multiplyByRealAndSum(r,r,-alp,z1);
@@ -103,3 +138,117 @@ int cg(sun_wferm *x,void (*A)(sun_wferm *r,sun_wferm *s),
 
    return n;
 }
+
+
+
+/* r=A*s (conj==0) or r=A^dag*s (conj==1) for the Schur complement
+ * A=fm-D_eo*D_oe/fm on the even points, r and s in even-odd ordering */
+static void applySchurOperator(sun_wferm *r,sun_wferm *s,int conj,double fm)
+{
+   if(conj==0)
+   {
+      applyHoppingTermEo(r,s,1);
+      applyHoppingTermEo(r,r,0);
+   }
+   else
+   {
+      applyComplexConjHoppingTermEo(r,s,1);
+      applyComplexConjHoppingTermEo(r,r,0);
+   }
+   multiplyByRealAndSumHalf(r,s,-1./(fm*fm),r);
+   multiplyByRealHalf(r,fm,r);
+}
+
+
+/* CG for A^dag*A*x_e=A^dag*b_e with x_e,b_e the even parts of xe,be */
+static int schurCg(double fm,double tol,int nmax)
+{
+   int n;
+   double alp,xi1,xi2;
+
+   applySchurOperator(z2,xe,0,fm);
+   multiplyByRealAndSumHalf(z2,be,-1.,z2);
+   applySchurOperator(r,z2,1,fm);
+   xi1=globalSquareNormHalf(r);
+   if(sqrt(xi1)<tol)
+      return 0;
+   copySpinorsHalf(p,r);
+
+   for(n=0;n<nmax;n++)
+   {
+      applySchurOperator(z2,p,0,fm);
+      applySchurOperator(z1,z2,1,fm);
+
+      xi2=realPartOfScalarProdHalf(p,z1);
+      alp=xi1/xi2;
+      multiplyByRealAndSumHalf(xe,xe,alp,p);
+      multiplyByRealAndSumHalf(r,r,-alp,z1);
+
+      xi2=globalSquareNormHalf(xe);
+      if((100.0*DBL_EPSILON*sqrt(xi2))>tol)
+      {
+         n=-2;
+         break;
+      }
+      xi2=globalSquareNormHalf(r);
+      if(sqrt(xi2)<tol)
+      {
+         n++;
+         break;
+      }
+
+      alp=xi2/xi1;
+      xi1=xi2;
+      multiplyByRealAndSumHalf(p,r,alp,p);
+   }
+   if(n==nmax)
+      n=-1;
+
+   return n;
+}
+
+
+
+int cg_eo(sun_wferm *x,sun_wferm *b,double eps,int nmax)
+{
+   int n,nit;
+   double fm,tol,tols,res;
+
+   error(init==0,"cg_eo [solv_cg.c]","CG not initialised!");
+
+   fm=(4.+runParams.mass);
+
+   applyComplexConjDiracOperator(z1,b);
+   tol=eps*sqrt(globalSquareNorm(z1));
+
+   reorderSpinorsToEvenOdd(xe,x);
+   reorderSpinorsToEvenOdd(be,b);
+   applyHoppingTermEo(z1,be,0);
+   multiplyByRealAndSumHalf(be,be,-1./fm,z1);
+
+   /* the Schur complement residual differs from the one of the full
+    * operator, the tolerance is tightened until the latter is reached */
+   tols=tol;
+   for(nit=0;;)
+   {
+      n=schurCg(fm,tols,nmax-nit);
+      if(n<0)
+         return n;
+      nit+=n;
+
+      applyHoppingTermEo(xe,xe,1);
+      multiplyByRealAndSumHalf(xe+VOL/2,be+VOL/2,-1.,xe+VOL/2);
+      multiplyByRealHalf(xe+VOL/2,1./fm,xe+VOL/2);
+      reorderSpinorsToLexicographic(x,xe);
+
+      applyWilsonDiracOperator(z2,x);
+      multiplyByRealAndSum(z2,b,-1.,z2);
+      applyComplexConjDiracOperator(z1,z2);
+      res=sqrt(globalSquareNorm(z1));
+      if(res<tol)
+         return nit;
+      if(nit>=nmax)
+         return -1;
+      tols*=0.5*tol/res;
+   }
+}
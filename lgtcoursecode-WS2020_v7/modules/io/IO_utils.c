@@ -17,6 +17,7 @@
 *      Note: The argument consists of a format string and possible additional
 *            entries.
 *            -> usage like printf.
+*      With MPI_PARALLEL 1 only the process with rank 0 writes.
 * 
 * void error(int test,char *name,char *format,...)
 *      Tests whether test=TRUE. If so, it aborts the program after printing
@@ -26,6 +27,7 @@
 *            name should conventionally contain the name of the calling
 *                 function and in brackets the filename where it is included.
 *            -> Makes error detection easier!
+*      With MPI_PARALLEL 1 all processes are aborted.
 * 
 * void checkpoint(char *format,...)
 *      In DEBUG-mode it writes a message to the logfile (like 'logging').
@@ -49,6 +51,10 @@ void logging(char *format,...)
    FILE *flog=NULL;
    va_list args;
 
+#if(MPI_PARALLEL==1)
+   if(mpiRank()!=0)
+      return;
+#endif
    flog=fopen(LOG_FILE,"ab");
    va_start(args,format);
    vfprintf(flog,format,args);
@@ -75,6 +81,9 @@ void error(int test,char *name,char *format,...)
       fprintf(flog,"\nProgram aborted!!!\n\n");
       fflush(flog);
       fclose(flog);
+#if(MPI_PARALLEL==1)
+      abortMpi(-1);
+#endif
       exit(-1);
    }
 }
@@ -19,7 +19,87 @@
  * void readConfig(char *infile)
  *      Reads the gauge field from the file whose name is handed to the
  *      function via the string infile and stores it into the standard gauge
- *      field.
+ *      field. Without master field the file contains a CRC-32C checksum of
+ *      every time slice (see crc32c.c) after the plaquette, which is checked
+ *      while reading. Files written before without the checksums are
+ *      recognised by their size and checked with the plaquette instead.
+ *
+ * int writeConfigSublattice(char *outfile, double *f, int n_sl)
+ * int readConfigSublattice(char *infile, double *f, int n_sl)
+ *      For master-field simulation. Write the core of the field f of
+ *      sublattice n_sl to, or read f with its outer layers from, the
+ *      master-field file. The positions in the file follow from the closed
+ *      form of masterFieldCoordinates in init.c. writeConfig and readConfig
+ *      call them with pu, where nstart is the sublattice, readConfig also
+ *      sets puSublattice (see headers.h) to nstart. They do not log,
+ *      such that they can be called from an I/O thread, and different
+ *      sublattices may be transferred by several threads at the same time.
+ *      The points are sorted by their position in the file and every
+ *      contiguous piece is transferred with one fseek. The number of pieces
+ *      is returned.
+ *
+ * void unmapConfig(void)
+ *      For master-field simulation with MF_IO_MMAP 1. Removes the memory
+ *      mapping of the master-field file (see below). Called by
+ *      writeHeaderToConfig and at the end of the program.
+ *
+ * void convertConfig(char *infile, char *outfile, int layout)
+ *      For master-field simulation. Converts the master-field file infile
+ *      into outfile with the file layout 'layout' (see below), infile must
+ *      have the other layout. infile may also be a file of format version
+ *      0 (see below), outfile always has the current version. The
+ *      conversion proceeds sublattice by sublattice, such that only one
+ *      sublattice is held in memory.
+ *
+ * Master-field files start with the header MF_MAGIC, the format version
+ * MF_VERSION, the file layout, DIM, SUN and the master-field extents. With
+ * MF_FILE_LAYOUT 0 (see headers.h) the links of the points
+ * follow in the lexicographic order of the master field. With MF_FILE_LAYOUT
+ * 1 the header also contains the sublattice extents and the sublattices
+ * follow one after the other. Within a sublattice the points are ordered by
+ * whether their coordinates lie on the first, an inner or the last slice of
+ * each direction, so that the outer layers of a sublattice are read in a
+ * fixed number of contiguous pieces (at most 545 for DIM 4) besides the one
+ * of the core. In the lexicographic layout the number of pieces grows with
+ * the sublattice volume. If the sublattice grid is shifted (see
+ * shiftMasterField in init.c) a sublattice covers parts of up to 2^DIM
+ * blocks and is transferred in correspondingly more pieces.
+ *
+ * The header of master-field files ends with a table of VOL_SL entries
+ * {flag,checksum}, one for every block of the unshifted sublattice grid.
+ * When the core of a sublattice of the unshifted grid is written, the
+ * CRC-32C checksum of its links in the file is stored with flag 1, and it
+ * is checked when the sublattice is read. Writing a sublattice of the
+ * shifted grid sets the flags of all blocks it overlaps to 0, these are
+ * not checked until they are written again on the unshifted grid.
+ *
+ * Files of format version 0, written before, start directly with DIM and
+ * have no checksum table. They are only read by convertConfig, the other
+ * functions reject them as well as files of unknown versions or with the
+ * other layout.
+ *
+ * With MF_IO_MMAP 1 (see headers.h) the master-field file is mapped into
+ * memory (MAP_SHARED) when a sublattice is first read or written and stays
+ * mapped until another file is accessed. A file that only contains the
+ * header is extended to its full size when a sublattice is written to it,
+ * reading from a shorter file is an error. The pieces are copied from or to
+ * the mapping, without opening the file or a system call per piece, and
+ * the page cache takes care of reading ahead and writing back. Files larger
+ * than the memory are thus possible. In the blocked layout the block of the
+ * next sublattice is prefetched with madvise(MADV_WILLNEED) after a read and
+ * the block of a written sublattice is released with madvise(MADV_DONTNEED),
+ * unless the sublattice grid is shifted (see shiftMasterField in init.c).
+ * The links are always copied, since the sublattice fields contain the
+ * outer layers and are stored in the layout of gfield.h.
+ *
+ * With MF_HALO_CACHE>0 (see headers.h) the links on the boundary of the
+ * core of the last MF_HALO_CACHE written sublattices are kept in memory.
+ * These are the points that form the outer layers of the neighbouring
+ * sublattices. When a sublattice is read, the outer layers found in the
+ * cache are copied from memory and only the rest is read from the file. A
+ * written sublattice replaces all entries whose cores overlap with its
+ * core, so the cache always agrees with the file. It is emptied when
+ * another file is accessed or a header is written.
  *
  *******************************************************************************/
 
@@ -33,6 +113,12 @@
 #include "misc.h"
 #include "headers.h"
 #include "modules.h"
+#if ((MASTER_FIELD == 1) && (MF_IO_MMAP == 1))
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #define DEBUG_IO 0
 
@@ -43,9 +129,11 @@ void writeConfig(char *outfile, int nstart)
     int ii, in, iend;
     long int icheck, icheck2;
     stdint_t lswrite[DIM], info[2];
+    stduint_t crc[LENGT];
     double plaq;
     double *zw, *buff = NULL;
     double t1, t2;
+    sun_mat u;
 
     checkpoint("write_config -- in");
     logging("\nWriting configuration %s:\n", outfile);
@@ -88,6 +176,12 @@ void writeConfig(char *outfile, int nstart)
     icheck += fwrite(&plaq, sizeof(double), 1, fout);
     error(icheck != DIM + 3, "write_config [config_IO.c]", "Write error!");
 
+    /* the checksums of the time slices are filled in at the end */
+    for (ii = 0; ii < LENGT; ii++)
+        crc[ii] = 0;
+    icheck = fwrite(crc, sizeof(stduint_t), LENGT, fout);
+    error(icheck != LENGT, "write_config [config_IO.c]", "Write error!");
+
     buff = malloc(SUNVOL * DIM * sizeof(double));
     error(buff == NULL, "write_config [config_IO.c]", "Unable to allocate buffers!");
 
@@ -95,18 +189,30 @@ void writeConfig(char *outfile, int nstart)
     for (in = 0; in < VOL; in++)
     {
         for (ii = 0, zw = buff; ii < DIM; ii++, zw += SUNVOL)
-            mk_sun_dble_array(zw, *pu[in][ii]);
+        {
+            gf_get(u, pu, in, ii);
+            mk_sun_dble_array(zw, u);
+        }
 
         if (iend == BIG_ENDIAN)
         {
             bswap_double(SUNVOL * DIM, buff);
         }
+        crc[in / SVOL] = crc32c(crc[in / SVOL], buff, SUNVOL * DIM * sizeof(double));
         icheck += fwrite(buff, sizeof(double), SUNVOL * DIM, fout);
     }
 
     icheck2 = DIM * SUNVOL * VOL;
     error(icheck != icheck2, "write_config [config_IO.c]", "Write error!");
 
+    if (iend == BIG_ENDIAN)
+    {
+        bswap_int(LENGT, (stdint_t *)(crc));
+    }
+    fseek(fout, (long int)((2 + DIM) * sizeof(stdint_t) + sizeof(double)), SEEK_SET);
+    icheck = fwrite(crc, sizeof(stduint_t), LENGT, fout);
+    error(icheck != LENGT, "write_config [config_IO.c]", "Write error!");
+
     fclose(fout);
 
     free(buff);
@@ -116,114 +222,929 @@ void writeConfig(char *outfile, int nstart)
     logging("\nConfiguration exported (took %.3e sec)!\n", t2 - t1);
 }
 #elif (MASTER_FIELD == 1)
-static long int offset_header;
+/* maximal number of points transferred with one fread or fwrite */
+#define NREC_BUF 4096
 
-void writeHeaderToConfig(char *outfile)
+/* first word of the master-field files and version of their format, files
+ * of version 0 start with DIM and have no checksum table */
+#define MF_MAGIC 0x464d474c
+#define MF_VERSION 1
+
+/* point of a sublattice and its position in the file */
+typedef struct
 {
-    FILE *fout = NULL;
-    stdint_t lswrite[DIM], info[2];
-    double t1, t2;
-    int iend, icheck;
-    // double plaq;
+    long int pos;
+    int in, core;
+} site_rec;
+
+static int blk_init = 0;
+static int blk[VOL];
+
+/* Order of the points within a sublattice in the blocked layout. The points
+ * are sorted by the class (first, inner or last slice) of their coordinate
+ * in each direction, the first direction being the slowest. The faces,
+ * edges and corners, which are the outer layers of the neighbouring
+ * sublattices, then consist of a number of contiguous pieces that does not
+ * depend on the sublattice extents. */
+static void initBlockOrder(void)
+{
+    int in, dir, rest, x, fac, key, nkey;
+    int latticeExtent[DIM], latticeExtent_mf[DIM];
+    int *keys, *start;
 
-    checkpoint("write_header_config -- in");
-    logging("\nWriting configuration header %s:\n", outfile);
-    t1 = getTime();
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+
+    for (dir = 0, nkey = 1; dir < DIM; dir++)
+        nkey *= 3;
+
+    keys = malloc(VOL * sizeof(int));
+    start = calloc(nkey + 1, sizeof(int));
+    error((keys == NULL) || (start == NULL), "initBlockOrder [config_IO.c]",
+          "Unable to allocate buffers!");
+
+    for (in = 0; in < VOL; in++)
+    {
+        rest = in;
+        key = 0;
+        for (dir = DIM - 1, fac = 1; dir >= 0; dir--, fac *= 3)
+        {
+            x = rest % latticeExtent[dir];
+            rest /= latticeExtent[dir];
+            if (x == latticeExtent[dir] - 1)
+                key += 2 * fac;
+            else if (x != 0)
+                key += fac;
+        }
+        keys[in] = key;
+        start[key + 1]++;
+    }
+
+    for (key = 0; key < nkey; key++)
+        start[key + 1] += start[key];
+    for (in = 0; in < VOL; in++)
+        blk[in] = start[keys[in]]++;
+
+    free(start);
+    free(keys);
+    blk_init = 1;
+}
+
+/* Contributions of the coordinates of the points of sublattice n_sl to
+ * their position in the file, see masterFieldCoordinates in init.c for the
+ * ordering of the tables. In the lexicographic layout the position is the
+ * sum of the pos_tab entries of all directions, in the blocked layout
+ * this sum is the sublattice that contains the point and the sum of the
+ * in_tab entries the normal index on it. */
+static void positionTables(int n_sl, int layout, long int *pos_tab, int *in_tab)
+{
+    int dir, x, off, xmf;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], xtab[LSUM2];
+    long int fmf, fsl, fin;
+
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+    masterFieldCoordinates(n_sl, xtab);
+
+    fmf = 1;
+    fsl = 1;
+    fin = 1;
+    for (dir = DIM - 1, off = LSUM2; dir >= 0; dir--)
+    {
+        off -= latticeExtent[dir] + 2;
+        for (x = 0; x < latticeExtent[dir] + 2; x++)
+        {
+            xmf = xtab[off + x];
+            if (layout == 0)
+            {
+                pos_tab[off + x] = fmf * xmf;
+                in_tab[off + x] = 0;
+            }
+            else
+            {
+                pos_tab[off + x] = fsl * (xmf / latticeExtent[dir]);
+                in_tab[off + x] = (int)(fin * (xmf % latticeExtent[dir]));
+            }
+        }
+        fmf *= latticeExtent_mf[dir];
+        fsl *= latticeExtent_mf[dir] / latticeExtent[dir];
+        fin *= latticeExtent[dir];
+    }
+}
+
+/* Position of the checksum table, which follows the extents in the header */
+static long int tableOffset(int layout)
+{
+    if (layout == 0)
+        return (long int)((5 + DIM) * sizeof(stdint_t));
+    else
+        return (long int)((5 + 2 * DIM) * sizeof(stdint_t));
+}
+
+/* Size of the header of a file of format version 0 or MF_VERSION */
+static long int headerSize(int layout, int version)
+{
+    if (version == 0)
+        return (long int)((2 + ((layout == 0) ? DIM : 2 * DIM)) * sizeof(stdint_t));
+    else
+        return tableOffset(layout) + (long int)(2 * VOL_SL * sizeof(stduint_t));
+}
+
+/* Reads (iwrite==0) or writes (iwrite==1) the entry {flag,checksum} of the
+ * block n_blk in the checksum table of the open file fp or, if fp==NULL, of
+ * the memory mapping map of the file */
+static void checksumEntry(FILE *fp, char *map, int layout, int n_blk, int iwrite, stduint_t *entry)
+{
+    long int pos, icheck;
+    stduint_t e[2];
+
+    pos = tableOffset(layout) + (long int)(2 * n_blk * sizeof(stduint_t));
+
+    if (iwrite == 1)
+    {
+        e[0] = entry[0];
+        e[1] = entry[1];
+        if (endianness() == BIG_ENDIAN)
+        {
+            bswap_int(2, (stdint_t *)(e));
+        }
+        if (fp == NULL)
+            memcpy(map + pos, e, sizeof(e));
+        else
+        {
+            fseek(fp, pos, SEEK_SET);
+            icheck = fwrite(e, sizeof(stduint_t), 2, fp);
+            error(icheck != 2, "checksumEntry [config_IO.c]", "Write error!");
+        }
+    }
+    else
+    {
+        if (fp == NULL)
+            memcpy(e, map + pos, sizeof(e));
+        else
+        {
+            fseek(fp, pos, SEEK_SET);
+            icheck = fread(e, sizeof(stduint_t), 2, fp);
+            error(icheck != 2, "checksumEntry [config_IO.c]", "Read error!");
+        }
+        if (endianness() == BIG_ENDIAN)
+        {
+            bswap_int(2, (stdint_t *)(e));
+        }
+        entry[0] = e[0];
+        entry[1] = e[1];
+    }
+}
+
+/* Marks the checksums of all blocks that overlap with the core of the
+ * sublattice n_sl of the shifted grid as invalid */
+static void invalidateChecksums(FILE *fp, char *map, int layout, int n_sl)
+{
+    int c, dir, off, n_blk, b;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], xtab[LSUM2], blo[DIM], bhi[DIM];
+    stduint_t entry[2] = {0, 0};
+
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+    masterFieldCoordinates(n_sl, xtab);
+
+    for (dir = 0, off = 0; dir < DIM; off += latticeExtent[dir] + 2, dir++)
+    {
+        blo[dir] = xtab[off + 1] / latticeExtent[dir];
+        bhi[dir] = xtab[off + latticeExtent[dir]] / latticeExtent[dir];
+    }
+
+    for (c = 0; c < (1 << DIM); c++)
+    {
+        for (dir = 0, n_blk = 0; dir < DIM; dir++)
+        {
+            b = ((c >> dir) & 1) ? bhi[dir] : blo[dir];
+            n_blk = n_blk * (latticeExtent_mf[dir] / latticeExtent[dir]) + b;
+        }
+        checksumEntry(fp, map, layout, n_blk, 1, entry);
+    }
+}
+
+static int comparePositions(const void *a, const void *b)
+{
+    long int pa, pb;
+
+    pa = ((const site_rec *)a)->pos;
+    pb = ((const site_rec *)b)->pos;
+
+    return (pa > pb) - (pa < pb);
+}
+
+/* Writes (iwrite==1) the core points of f to the open file fp or reads
+ * (iwrite==0) all VOL2 points of f from it, where f is the field of the
+ * sublattice n_sl. The points are sorted by their position in the file and each
+ * contiguous piece is transferred after a single fseek. If fp==NULL the
+ * pieces are copied from or to the memory mapping map of the file instead.
+ * When reading, the points n with skip[n]!=0 are left out if skip!=NULL.
+ * Files of format version 0 are only read, without checksum test.
+ * Returns the number of pieces. */
+static int transferSites(FILE *fp, char *map, int layout, int version, double *f, int n_sl, int iwrite,
+                         char *skip)
+{
+    int n, k, nb, nsite, nskip, npiece, ii, iend, dir, off, core, in;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], x[DIM], in_tab[LSUM2];
+    long int icheck, icheck2, pos, pos_tab[LSUM2];
+    size_t nbyte, nrec;
+    stduint_t crc, entry[2];
+    char *ptr = NULL;
+    double *zw, *buff = NULL;
+    site_rec *rec = NULL;
+    sun_mat u;
+
+    /* sublattices may be transferred by several threads (see mf_colour.c) */
+#pragma omp critical(config_IO)
+    {
+        if ((layout == 1) && (blk_init == 0))
+            initBlockOrder();
+    }
+
+    iend = endianness();
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+    positionTables(n_sl, layout, pos_tab, in_tab);
+
+    rec = malloc(VOL2 * sizeof(site_rec));
+    buff = malloc(NREC_BUF * SUNVOL * DIM * sizeof(double));
+    error((rec == NULL) || (buff == NULL), "transferSites [config_IO.c]",
+          "Unable to allocate buffers!");
+
+    /* run through the points of the bigger lattice, the last direction
+     * fastest, and add up the contributions to their positions */
+    for (dir = 0; dir < DIM; dir++)
+        x[dir] = 0;
+    nsite = 0;
+    nskip = 0;
+    for (n = 0; n < VOL2; n++)
+    {
+        pos = 0;
+        in = 0;
+        core = 1;
+        for (dir = 0, off = 0; dir < DIM; off += latticeExtent[dir] + 2, dir++)
+        {
+            pos += pos_tab[off + x[dir]];
+            in += in_tab[off + x[dir]];
+            if ((x[dir] == 0) || (x[dir] == latticeExtent[dir] + 1))
+                core = 0;
+        }
+
+        if ((iwrite == 0) && (skip != NULL) && (skip[n] != 0))
+            nskip++;
+        else if ((iwrite == 0) || (core == 1))
+        {
+            rec[nsite].in = n;
+            rec[nsite].core = core;
+            rec[nsite].pos = (layout == 0) ? pos : (pos * (long int)(VOL) + (long int)(blk[in]));
+            nsite++;
+        }
+
+        for (dir = DIM - 1; dir >= 0; dir--)
+        {
+            if (x[dir] + 1 < latticeExtent[dir] + 2)
+            {
+                x[dir]++;
+                break;
+            }
+            x[dir] = 0;
+        }
+    }
+    error(nsite != ((iwrite == 1) ? VOL : (VOL2 - nskip)), "transferSites [config_IO.c]",
+          "Wrong number of points!");
+    qsort(rec, nsite, sizeof(site_rec), comparePositions);
+
+    icheck = 0;
+    npiece = 0;
+    crc = 0;
+    nrec = SUNVOL * DIM * sizeof(double);
+    for (n = 0; n < nsite; n += nb)
+    {
+        for (nb = 1; (n + nb < nsite) && (nb < NREC_BUF) && (rec[n + nb].pos == rec[n].pos + nb); nb++)
+            ;
+
+        if ((n == 0) || (rec[n].pos != rec[n - 1].pos + 1))
+        {
+            if (fp == NULL)
+                ptr = map + headerSize(layout, version) + rec[n].pos * (long int)(SUNVOL * DIM * sizeof(double));
+            else
+                fseek(fp, headerSize(layout, version) + rec[n].pos * (long int)(SUNVOL * DIM * sizeof(double)),
+                      SEEK_SET);
+            npiece++;
+        }
+        nbyte = (size_t)(nb) * SUNVOL * DIM * sizeof(double);
+
+        if (iwrite == 1)
+        {
+            for (k = 0, zw = buff; k < nb; k++)
+            {
+                for (ii = 0; ii < DIM; ii++, zw += SUNVOL)
+                {
+                    gf_get(u, f, rec[n + k].in, ii);
+                    mk_sun_dble_array(zw, u);
+                }
+            }
+            if (iend == BIG_ENDIAN)
+            {
+                bswap_double(SUNVOL * DIM * nb, buff);
+            }
+            crc = crc32c(crc, buff, nbyte);
+            if (fp == NULL)
+            {
+                memcpy(ptr, buff, nbyte);
+                ptr += nbyte;
+                icheck += SUNVOL * DIM * nb;
+            }
+            else
+                icheck += fwrite(buff, sizeof(double), SUNVOL * DIM * nb, fp);
+        }
+        else
+        {
+            if (fp == NULL)
+            {
+                memcpy(buff, ptr, nbyte);
+                ptr += nbyte;
+                icheck += SUNVOL * DIM * nb;
+            }
+            else
+                icheck += fread(buff, sizeof(double), SUNVOL * DIM * nb, fp);
+            for (k = 0; k < nb; k++)
+            {
+                if (rec[n + k].core == 1)
+                    crc = crc32c(crc, (char *)(buff) + k * nrec, nrec);
+            }
+            if (iend == BIG_ENDIAN)
+            {
+                bswap_double(SUNVOL * DIM * nb, buff);
+            }
+            for (k = 0, zw = buff; k < nb; k++)
+            {
+                for (ii = 0; ii < DIM; ii++, zw += SUNVOL)
+                {
+                    mk_dble_array_sun(zw, u);
+                    gf_set(f, rec[n + k].in, ii, u);
+                }
+            }
+        }
+    }
+
+    icheck2 = (long int)(DIM * SUNVOL) * (long int)(nsite);
+    error(icheck != icheck2, "transferSites [config_IO.c]", (iwrite == 1) ? "Write error!" : "Read error!");
+
+    /* the checksums belong to the blocks of the unshifted grid */
+    if (version == 0)
+        error(iwrite == 1, "transferSites [config_IO.c]", "Files of version 0 cannot be written!");
+    else if (masterFieldShifted() == 0)
+    {
+        if (iwrite == 1)
+        {
+            entry[0] = 1;
+            entry[1] = crc;
+            checksumEntry(fp, map, layout, n_sl, 1, entry);
+        }
+        else
+        {
+            checksumEntry(fp, map, layout, n_sl, 0, entry);
+            error((entry[0] == 1) && (entry[1] != crc), "transferSites [config_IO.c]",
+                  "Checksum test failed for sublattice %d!", n_sl);
+        }
+    }
+    else if (iwrite == 1)
+        invalidateChecksums(fp, map, layout, n_sl);
+
+    free(buff);
+    free(rec);
+
+    return npiece;
+}
+
+static void writeHeader(char *outfile, int layout)
+{
+    FILE *fout = NULL;
+    stdint_t lswrite[2 * DIM], info[5];
+    stduint_t *table;
+    int iend, icheck, nls;
 
 #if (DIM == 2)
     lswrite[0] = (stdint_t)(LENGT_MF);
     lswrite[1] = (stdint_t)(LENGS1_MF);
+    lswrite[2] = (stdint_t)(LENGT);
+    lswrite[3] = (stdint_t)(LENGS1);
 #elif (DIM == 3)
     lswrite[0] = (stdint_t)(LENGT_MF);
     lswrite[1] = (stdint_t)(LENGS1_MF);
     lswrite[2] = (stdint_t)(LENGS2_MF);
+    lswrite[3] = (stdint_t)(LENGT);
+    lswrite[4] = (stdint_t)(LENGS1);
+    lswrite[5] = (stdint_t)(LENGS2);
 #elif (DIM == 4)
     lswrite[0] = (stdint_t)(LENGT_MF);
     lswrite[1] = (stdint_t)(LENGS1_MF);
     lswrite[2] = (stdint_t)(LENGS2_MF);
     lswrite[3] = (stdint_t)(LENGS3_MF);
+    lswrite[4] = (stdint_t)(LENGT);
+    lswrite[5] = (stdint_t)(LENGS1);
+    lswrite[6] = (stdint_t)(LENGS2);
+    lswrite[7] = (stdint_t)(LENGS3);
 #endif
+    /* the blocked layout also stores the sublattice extents */
+    nls = (layout == 0) ? DIM : 2 * DIM;
     iend = endianness();
-    // plaq = plaquette();
-    icheck = 0;
 
     fout = fopen(outfile, "wb");
     error(fout == NULL, "write_config [config_IO.c]", "Unable to create output file %s!", outfile);
 
-    info[0] = DIM;
-    info[1] = SUN;
+    info[0] = MF_MAGIC;
+    info[1] = MF_VERSION;
+    info[2] = layout;
+    info[3] = DIM;
+    info[4] = SUN;
 
     if (iend == BIG_ENDIAN)
     {
-        bswap_int(2, info);
-        bswap_int(DIM, lswrite);
-        // bswap_double(1, &plaq);
+        bswap_int(5, info);
+        bswap_int(nls, lswrite);
     }
 
-    icheck = fwrite(info, sizeof(stdint_t), 2, fout);
-    icheck += fwrite(lswrite, sizeof(stdint_t), DIM, fout);
-    // icheck += fwrite(&plaq, sizeof(double), 1, fout);
+    icheck = fwrite(info, sizeof(stdint_t), 5, fout);
+    icheck += fwrite(lswrite, sizeof(stdint_t), nls, fout);
+    error(icheck != nls + 5, "write_config [config_IO.c]", "Write error!");
 
-    offset_header = ftell(fout);
+    /* no block has a valid checksum yet */
+    table = calloc(2 * VOL_SL, sizeof(stduint_t));
+    error(table == NULL, "write_config [config_IO.c]", "Unable to allocate buffers!");
+    icheck = fwrite(table, sizeof(stduint_t), 2 * VOL_SL, fout);
+    error(icheck != 2 * VOL_SL, "write_config [config_IO.c]", "Write error!");
+    free(table);
+    error(ftell(fout) != headerSize(layout, MF_VERSION), "write_config [config_IO.c]", "Wrong header size!");
 
-    // check 2 statt 3 wegen plaq
-    error(icheck != DIM + 2, "write_config [config_IO.c]", "Write error!");
-    checkpoint("write_header_config -- out");
-    t2 = getTime();
-    logging("\nConfiguration exported (took %.3e sec)!\n", t2 - t1);
     fclose(fout);
 }
 
-void writeConfig(char *outfile, int nstart)
+/* Reads the header of the open file fin and checks it against the lattice
+ * and the file layout. Returns the format version of the file. Files of
+ * version 0 are only accepted if iold==1, other versions are rejected. */
+static int checkHeader(FILE *fin, int layout, int iold)
 {
-    FILE *fout = NULL;
-    int ii, in, iend;
-    long int icheck, icheck2;
-    long int pos;
-    // long int offset_header;
-    double *zw, *buff = NULL;
-    double t1, t2;
-
-    checkpoint("write_config -- in");
-    logging("\nWriting configuration %s at position %d:\n", outfile, nstart);
-    t1 = getTime();
+    int ii, iend, nls, version;
+    long int icheck;
+    int ileng[2 * DIM];
+    stdint_t info[3], lscheck[2 * DIM];
 
+/*added master-field extents*/
+#if (DIM == 2)
+    ileng[0] = LENGT_MF;
+    ileng[1] = LENGS1_MF;
+    ileng[2] = LENGT;
+    ileng[3] = LENGS1;
+#elif (DIM == 3)
+    ileng[0] = LENGT_MF;
+    ileng[1] = LENGS1_MF;
+    ileng[2] = LENGS2_MF;
+    ileng[3] = LENGT;
+    ileng[4] = LENGS1;
+    ileng[5] = LENGS2;
+#elif (DIM == 4)
+    ileng[0] = LENGT_MF;
+    ileng[1] = LENGS1_MF;
+    ileng[2] = LENGS2_MF;
+    ileng[3] = LENGS3_MF;
+    ileng[4] = LENGT;
+    ileng[5] = LENGS1;
+    ileng[6] = LENGS2;
+    ileng[7] = LENGS3;
+#endif
+    nls = (layout == 0) ? DIM : 2 * DIM;
     iend = endianness();
-    icheck = 0;
 
-    fout = fopen(outfile, "rb+");
-    error(fout == NULL, "write_config [config_IO.c]", "Unable to create output file %s!", outfile);
+    icheck = fread(info, sizeof(stdint_t), 1, fin);
+    if (iend == BIG_ENDIAN)
+    {
+        bswap_int(1, info);
+    }
+    error(icheck != 1, "read_config [config_IO.c]", "Read error! (Master-field)");
 
-    buff = malloc(SUNVOL * DIM * sizeof(double));
-    error(buff == NULL, "write_config [config_IO.c]", "Unable to allocate buffers!");
+    if (info[0] == MF_MAGIC)
+    {
+        icheck = fread(info, sizeof(stdint_t), 2, fin);
+        if (iend == BIG_ENDIAN)
+        {
+            bswap_int(2, info);
+        }
+        error(icheck != 2, "read_config [config_IO.c]", "Read error! (Master-field)");
+        error(info[0] != MF_VERSION, "read_config [config_IO.c]", "Unknown file format version %d!", (int)(info[0]));
+        error(info[1] != layout, "read_config [config_IO.c]", "The file has layout %d instead of %d!",
+              (int)(info[1]), layout);
+        version = MF_VERSION;
+        icheck = fread(info, sizeof(stdint_t), 2, fin);
+    }
+    else
+    {
+        /* the file starts with DIM, which is swapped again below */
+        error(iold == 0, "read_config [config_IO.c]",
+              "File of format version 0 without checksums, convert it with convert_mf!");
+        version = 0;
+        if (iend == BIG_ENDIAN)
+        {
+            bswap_int(1, info);
+        }
+        icheck = 1 + fread(info + 1, sizeof(stdint_t), 1, fin);
+    }
+    icheck += fread(lscheck, sizeof(stdint_t), nls, fin);
 
-    // offset_header = 16UL + 4UL * (unsigned long)(DIM);
-    for (in = 0; in < VOL; in++)
+    if (iend == BIG_ENDIAN)
     {
-        for (ii = 0, zw = buff; ii < DIM; ii++, zw += SUNVOL)
-            mk_sun_dble_array(zw, *pu[i[in]][ii]);
+        bswap_int(2, info);
+        bswap_int(nls, lscheck);
+    }
+    error(icheck != nls + 2, "read_config [config_IO.c]", "Read error! (Master-field)");
+    error((info[0] != DIM) || (info[1] != SUN), "read_config [config_IO.c]", "Incompatible parameters!");
+    for (ii = 0; ii < DIM; ii++)
+    {
+        error(lscheck[ii] != ileng[ii], "read_config [config_IO.c]", "Incompatible master_field size!");
+    }
+    for (ii = DIM; ii < nls; ii++)
+    {
+        error(lscheck[ii] != ileng[ii], "read_config [config_IO.c]", "Incompatible sublattice size!");
+    }
 
-        if (iend == BIG_ENDIAN)
+    return version;
+}
+
+#if (MF_IO_MMAP == 1)
+static char *map = NULL, *map_name = NULL;
+static size_t map_size = 0;
+
+void unmapConfig(void)
+{
+    if (map != NULL)
+    {
+        munmap(map, map_size);
+        free(map_name);
+        map = NULL;
+        map_name = NULL;
+    }
+}
+
+/* Returns the shared memory mapping of the master-field file, which is
+ * created if file is not the one mapped at present. On the write path
+ * (iwrite=1) the file is extended to its full size if only the header has
+ * been written, on the read path it must already have its full size. */
+static char *mapConfig(char *file, int iwrite)
+{
+    FILE *fin = NULL;
+    int fd;
+    struct stat st;
+
+    if ((map != NULL) && (strcmp(map_name, file) == 0))
+        return map;
+    unmapConfig();
+
+    fin = fopen(file, "rb");
+    error(fin == NULL, "mapConfig [config_IO.c]", "Unable to read input file %s!", file);
+    checkHeader(fin, MF_FILE_LAYOUT, 0);
+    fclose(fin);
+
+    map_size = (size_t)(headerSize(MF_FILE_LAYOUT, MF_VERSION)) +
+               (size_t)(VOL_MF) * (size_t)(SUNVOL * DIM) * sizeof(double);
+
+    fd = open(file, O_RDWR);
+    error(fd < 0, "mapConfig [config_IO.c]", "Unable to open file %s!", file);
+    error(fstat(fd, &st) != 0, "mapConfig [config_IO.c]", "Unable to stat file %s!", file);
+    if ((size_t)(st.st_size) < map_size)
+    {
+        error(iwrite == 0, "mapConfig [config_IO.c]", "File %s is incomplete!", file);
+        error(ftruncate(fd, (off_t)(map_size)) != 0, "mapConfig [config_IO.c]",
+              "Unable to extend file %s!", file);
+    }
+
+    map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    error(map == MAP_FAILED, "mapConfig [config_IO.c]", "Unable to map file %s!", file);
+
+    map_name = malloc(strlen(file) + 1);
+    error(map_name == NULL, "mapConfig [config_IO.c]", "Unable to allocate buffers!");
+    strcpy(map_name, file);
+
+    return map;
+}
+
+/* madvise for the block of sublattice n_sl in the blocked layout. Pages are
+ * prefetched if they overlap with the block and released if they lie
+ * inside it. Nothing is done for a shifted sublattice grid, where the
+ * sublattices do not coincide with the blocks. */
+static void adviseBlock(int n_sl, int advice)
+{
+    size_t page, start, end;
+
+    if ((MF_FILE_LAYOUT != 1) || (n_sl < 0) || (n_sl >= VOL_SL) || masterFieldShifted())
+        return;
+
+    page = (size_t)(sysconf(_SC_PAGESIZE));
+    start = (size_t)(headerSize(MF_FILE_LAYOUT, MF_VERSION)) +
+            (size_t)(n_sl) * (size_t)(VOL) * (size_t)(SUNVOL * DIM) * sizeof(double);
+    end = start + (size_t)(VOL) * (size_t)(SUNVOL * DIM) * sizeof(double);
+
+    if (advice == MADV_WILLNEED)
+    {
+        start = (start / page) * page;
+        end = ((end + page - 1) / page) * page;
+        if (end > map_size)
+            end = map_size;
+    }
+    else
+    {
+        start = ((start + page - 1) / page) * page;
+        end = (end / page) * page;
+    }
+
+    if (end > start)
+        madvise(map + start, end - start, advice);
+}
+#else
+void unmapConfig(void)
+{
+}
+#endif
+
+#if (MF_HALO_CACHE > 0)
+/* boundary of the core of a sublattice, i.e. the core points with a
+ * coordinate on the first or last slice of some direction */
+static int bnd_init = 0, nbnd = 0;
+static int bnd_pos[VOL], bnd_in[VOL];
+
+/* links of the boundary of a written sublattice with the given origin */
+typedef struct
+{
+    int origin[DIM];
+    long int stamp;
+    sun_mat *u;
+} halo_entry;
+
+static halo_entry cache[MF_HALO_CACHE];
+static int ncache = 0;
+static long int cache_stamp = 0;
+static char *cache_name = NULL;
+
+static void initBoundary(void)
+{
+    int n, dir, x, rest, bnd;
+    int latticeExtent[DIM], latticeExtent_mf[DIM];
+
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+
+    for (n = 0, nbnd = 0; n < VOL; n++)
+    {
+        rest = n;
+        bnd = 0;
+        for (dir = DIM - 1; dir >= 0; dir--)
         {
-            bswap_double(SUNVOL * DIM, buff);
+            x = rest % latticeExtent[dir];
+            rest /= latticeExtent[dir];
+            if ((x == 0) || (x == latticeExtent[dir] - 1))
+                bnd = 1;
         }
+        bnd_pos[n] = (bnd == 1) ? nbnd : (-1);
+        if (bnd == 1)
+            bnd_in[nbnd++] = n;
+    }
+    bnd_init = 1;
+}
 
-        pos = index_mf[i[in]];
-        pos *= (long int)(sizeof(double) * SUNVOL * DIM);
-        fseek(fout, offset_header + pos, SEEK_SET);
-        icheck += fwrite(buff, sizeof(double), SUNVOL * DIM, fout);
+/* Empties the cache if it belongs to another file than file */
+static void selectHaloCache(char *file)
+{
+    if ((cache_name != NULL) && (strcmp(cache_name, file) == 0))
+        return;
+
+    free(cache_name);
+    cache_name = malloc(strlen(file) + 1);
+    error(cache_name == NULL, "selectHaloCache [config_IO.c]", "Unable to allocate buffers!");
+    strcpy(cache_name, file);
+    ncache = 0;
+}
+
+static void clearHaloCache(void)
+{
+    free(cache_name);
+    cache_name = NULL;
+    ncache = 0;
+}
+
+/* Stores the boundary of the sublattice n_sl of the field f, which has just
+ * been written to file. Entries whose cores overlap with the one of n_sl
+ * (the same sublattice, or one of a differently shifted grid) are dropped,
+ * such that the cache always agrees with the file. If the cache is full the
+ * oldest entry is replaced. */
+static void storeHalo(char *file, double *f, int n_sl)
+{
+    int j, k, ke, dir, off, d, overlap;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], xmf[LSUM2], origin[DIM];
+    sun_mat *u;
+    halo_entry zw;
+
+    if (bnd_init == 0)
+        initBoundary();
+    selectHaloCache(file);
+
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+    masterFieldCoordinates(n_sl, xmf);
+    for (dir = 0, off = 0; dir < DIM; off += latticeExtent[dir] + 2, dir++)
+        origin[dir] = xmf[off + 1];
+
+    for (k = 0; k < ncache;)
+    {
+        overlap = 1;
+        for (dir = 0; dir < DIM; dir++)
+        {
+            d = (cache[k].origin[dir] - origin[dir] + latticeExtent_mf[dir]) % latticeExtent_mf[dir];
+            if ((d >= latticeExtent[dir]) && (d <= latticeExtent_mf[dir] - latticeExtent[dir]))
+                overlap = 0;
+        }
+        if (overlap == 1)
+        {
+            /* keep the buffer behind the last entry */
+            ncache--;
+            zw = cache[k];
+            cache[k] = cache[ncache];
+            cache[ncache] = zw;
+        }
+        else
+            k++;
     }
 
-    icheck2 = DIM * SUNVOL * VOL;
-    error(icheck != icheck2, "write_config [config_IO.c]", "Write error!");
+    if (ncache < MF_HALO_CACHE)
+        ke = ncache++;
+    else
+    {
+        for (k = 1, ke = 0; k < ncache; k++)
+        {
+            if (cache[k].stamp < cache[ke].stamp)
+                ke = k;
+        }
+    }
+
+    if (cache[ke].u == NULL)
+    {
+        cache[ke].u = malloc(nbnd * DIM * sizeof(sun_mat));
+        error(cache[ke].u == NULL, "storeHalo [config_IO.c]", "Unable to allocate buffers!");
+    }
+    for (dir = 0; dir < DIM; dir++)
+        cache[ke].origin[dir] = origin[dir];
+    cache[ke].stamp = cache_stamp++;
+
+    for (j = 0, u = cache[ke].u; j < nbnd; j++)
+    {
+        for (dir = 0; dir < DIM; dir++, u++)
+            gf_get(*u, f, i[bnd_in[j]], dir);
+    }
+}
+
+/* Copies the outer layers of the sublattice n_sl which lie on the boundary
+ * of a cached sublattice into f and marks them in skip[VOL2]. Returns the
+ * number of copied points. */
+static int fetchHalo(char *file, double *f, int n_sl, char *skip)
+{
+    int k, j, n, dir, off, jn, core, nfetch, ok;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], xmf[LSUM2];
+    int nx[DIM], ix[DIM], xs[LSUM2], cs[LSUM2];
+    sun_mat *u;
+
+    if (bnd_init == 0)
+        initBoundary();
+    selectHaloCache(file);
+
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+    masterFieldCoordinates(n_sl, xmf);
+
+    nfetch = 0;
+    for (k = 0; k < ncache; k++)
+    {
+        /* points of the bigger lattice in the core of entry k, per direction */
+        ok = 1;
+        for (dir = 0, off = 0; dir < DIM; off += latticeExtent[dir] + 2, dir++)
+        {
+            nx[dir] = 0;
+            for (j = 0; j < latticeExtent[dir] + 2; j++)
+            {
+                cs[off + nx[dir]] = (xmf[off + j] - cache[k].origin[dir] + latticeExtent_mf[dir]) %
+                                    latticeExtent_mf[dir];
+                if (cs[off + nx[dir]] < latticeExtent[dir])
+                    xs[off + nx[dir]++] = j;
+            }
+            if (nx[dir] == 0)
+                ok = 0;
+            ix[dir] = 0;
+        }
+        if (ok == 0)
+            continue;
+
+        for (;;)
+        {
+            n = 0;
+            jn = 0;
+            core = 1;
+            for (dir = 0, off = 0; dir < DIM; off += latticeExtent[dir] + 2, dir++)
+            {
+                n = n * (latticeExtent[dir] + 2) + xs[off + ix[dir]];
+                jn = jn * latticeExtent[dir] + cs[off + ix[dir]];
+                if ((xs[off + ix[dir]] == 0) || (xs[off + ix[dir]] == latticeExtent[dir] + 1))
+                    core = 0;
+            }
+
+            /* the core of n_sl is read from the file */
+            if ((core == 0) && (skip[n] == 0) && (bnd_pos[jn] >= 0))
+            {
+                u = cache[k].u + bnd_pos[jn] * DIM;
+                for (dir = 0; dir < DIM; dir++)
+                    gf_set(f, n, dir, u[dir]);
+                skip[n] = 1;
+                nfetch++;
+            }
+
+            for (dir = DIM - 1; dir >= 0; dir--)
+            {
+                if (ix[dir] + 1 < nx[dir])
+                {
+                    ix[dir]++;
+                    break;
+                }
+                ix[dir] = 0;
+            }
+            if (dir < 0)
+                break;
+        }
+    }
+
+    return nfetch;
+}
+#endif
+
+void writeHeaderToConfig(char *outfile)
+{
+    double t1, t2;
+
+    checkpoint("write_header_config -- in");
+    logging("\nWriting configuration header %s:\n", outfile);
+    t1 = getTime();
+
+    /* the file is truncated, it must not be mapped */
+    unmapConfig();
+#if (MF_HALO_CACHE > 0)
+#pragma omp critical(mf_cache)
+    clearHaloCache();
+#endif
+
+    writeHeader(outfile, MF_FILE_LAYOUT);
+
+    checkpoint("write_header_config -- out");
+    t2 = getTime();
+    logging("\nConfiguration exported (took %.3e sec)!\n", t2 - t1);
+}
+
+int writeConfigSublattice(char *outfile, double *f, int n_sl)
+{
+    int npiece;
+
+#if (MF_IO_MMAP == 1)
+    char *m;
+
+#pragma omp critical(config_IO)
+    m = mapConfig(outfile, 1);
+    npiece = transferSites(NULL, m, MF_FILE_LAYOUT, MF_VERSION, f, n_sl, 1, NULL);
+    /* the written pages stay in the page cache for the outer layers */
+    adviseBlock(n_sl, MADV_DONTNEED);
+#else
+    FILE *fout = NULL;
+
+    fout = fopen(outfile, "rb+");
+    error(fout == NULL, "write_config [config_IO.c]", "Unable to create output file %s!", outfile);
+
+    npiece = transferSites(fout, NULL, MF_FILE_LAYOUT, MF_VERSION, f, n_sl, 1, NULL);
 
     fclose(fout);
+#endif
 
-    free(buff);
+#if (MF_HALO_CACHE > 0)
+#pragma omp critical(mf_cache)
+    storeHalo(outfile, f, n_sl);
+#endif
+
+    return npiece;
+}
+
+void writeConfig(char *outfile, int nstart)
+{
+    int npiece;
+    double t1, t2;
+
+    checkpoint("write_config -- in");
+    logging("\nWriting configuration %s at position %d:\n", outfile, nstart);
+    t1 = getTime();
+
+    npiece = writeConfigSublattice(outfile, pu, nstart);
 
     checkpoint("write_config -- out");
     t2 = getTime();
-    logging("\nConfiguration exported (took %.3e sec)!\n", t2 - t1);
+    logging("\nConfiguration exported in %d pieces (took %.3e sec)!\n", npiece, t2 - t1);
 }
 
 void prepareConfig(char *outfile)
@@ -232,10 +1153,49 @@ void prepareConfig(char *outfile)
     writeHeaderToConfig(outfile);
     for (n = 0; n < VOL_SL; n++)
     {
-        updateArrayOfIndexMF(n);
         writeConfig(outfile, n);
     }
 }
+
+void convertConfig(char *infile, char *outfile, int layout)
+{
+    FILE *fin = NULL, *fout = NULL;
+    int n, version;
+    double *f = NULL;
+    double t1, t2;
+
+    checkpoint("convertConfig -- in");
+    logging("\nConverting configuration %s to %s (layout %d):\n", infile, outfile, layout);
+    t1 = getTime();
+
+    error((layout != 0) && (layout != 1), "convertConfig [config_IO.c]", "Unknown file layout!");
+    error(strcmp(infile, outfile) == 0, "convertConfig [config_IO.c]",
+          "Input and output file must be different!");
+
+    allocateGaugeField(&f);
+
+    fin = fopen(infile, "rb");
+    error(fin == NULL, "read_config [config_IO.c]", "Unable to read input file %s!", infile);
+    version = checkHeader(fin, 1 - layout, 1);
+
+    writeHeader(outfile, layout);
+    fout = fopen(outfile, "rb+");
+    error(fout == NULL, "write_config [config_IO.c]", "Unable to create output file %s!", outfile);
+
+    for (n = 0; n < VOL_SL; n++)
+    {
+        transferSites(fin, NULL, 1 - layout, version, f, n, 0, NULL);
+        transferSites(fout, NULL, layout, MF_VERSION, f, n, 1, NULL);
+    }
+
+    fclose(fout);
+    fclose(fin);
+    deallocateGaugeField(&f);
+
+    checkpoint("convertConfig -- out");
+    t2 = getTime();
+    logging("\nConfiguration converted (took %.3e sec)!\n", t2 - t1);
+}
 #endif
 
 #if (MASTER_FIELD == 0)
@@ -243,12 +1203,14 @@ void readConfig(char *infile, int nstart)
 {
     FILE *fin = NULL;
     int ii, in, iend;
-    long int icheck, icheck2;
-    int ileng[DIM];
+    long int icheck, icheck2, pos, size;
+    int ileng[DIM], ncrc;
     stdint_t lscheck[DIM], info[2];
+    stduint_t crc[LENGT], crc0[LENGT];
     double plaq, plaq0, eps;
     double *zw, *buff = NULL;
     double t1, t2;
+    sun_mat u;
 
     checkpoint("read_config -- in");
     logging("\nReading configuration %s:\n", infile);
@@ -268,7 +1230,7 @@ void readConfig(char *infile, int nstart)
     ileng[3] = LENGS3;
 #endif
 
-    error(pu[0][0] == NULL, "read_config [config_IO.c]", "Fields are not allocated!");
+    error(pu == NULL, "read_config [config_IO.c]", "Fields are not allocated!");
 
     iend = endianness();
     icheck = 0;
@@ -292,6 +1254,27 @@ void readConfig(char *infile, int nstart)
         error(lscheck[ii] != ileng[ii], "read_config [config_IO.c]", "Incompatible lattice size!");
     }
 
+    /* files without the checksums of the time slices are checked with the
+     * plaquette */
+    pos = ftell(fin);
+    fseek(fin, 0, SEEK_END);
+    size = ftell(fin) - pos - (long int)(VOL) * (long int)(SUNVOL * DIM * sizeof(double));
+    fseek(fin, pos, SEEK_SET);
+    error((size != 0) && (size != (long int)(LENGT * sizeof(stduint_t))), "read_config [config_IO.c]",
+          "Wrong file size!");
+    ncrc = (size == 0) ? 0 : LENGT;
+    if (ncrc > 0)
+    {
+        icheck = fread(crc0, sizeof(stduint_t), LENGT, fin);
+        error(icheck != LENGT, "read_config [config_IO.c]", "Read error!");
+        if (iend == BIG_ENDIAN)
+        {
+            bswap_int(LENGT, (stdint_t *)(crc0));
+        }
+        for (ii = 0; ii < LENGT; ii++)
+            crc[ii] = 0;
+    }
+
     buff = malloc(SUNVOL * DIM * sizeof(double));
     error(buff == NULL, "read_config [config_IO.c]", "Unable to allocate buffers!");
 
@@ -299,13 +1282,18 @@ void readConfig(char *infile, int nstart)
     for (in = 0; in < VOL; in++)
     {
         icheck += fread(buff, sizeof(double), SUNVOL * DIM, fin);
+        if (ncrc > 0)
+            crc[in / SVOL] = crc32c(crc[in / SVOL], buff, SUNVOL * DIM * sizeof(double));
         if (iend == BIG_ENDIAN)
         {
             bswap_double(SUNVOL * DIM, buff);
         }
 
         for (ii = 0, zw = buff; ii < DIM; ii++, zw += SUNVOL)
-            mk_dble_array_sun(zw, *pu[in][ii]);
+        {
+            mk_dble_array_sun(zw, u);
+            gf_set(pu, in, ii, u);
+        }
     }
 
     icheck2 = DIM * SUNVOL * VOL;
@@ -313,9 +1301,20 @@ void readConfig(char *infile, int nstart)
 
     fclose(fin);
 
-    plaq = plaquette();
-    eps = sqrt((double)(NPLAQ * VOL)) * DBL_EPSILON;
-    error(fabs(plaq - plaq0) > eps, "read_config [config_IO.c]", "Plaquette test failed!");
+    if (ncrc > 0)
+    {
+        for (ii = 0; ii < LENGT; ii++)
+        {
+            error(crc[ii] != crc0[ii], "read_config [config_IO.c]",
+                  "Checksum test failed for time slice %d!", ii);
+        }
+    }
+    else
+    {
+        plaq = plaquette();
+        eps = sqrt((double)(NPLAQ * VOL)) * DBL_EPSILON;
+        error(fabs(plaq - plaq0) > eps, "read_config [config_IO.c]", "Plaquette test failed!");
+    }
 
     free(buff);
 
@@ -324,98 +1323,59 @@ void readConfig(char *infile, int nstart)
     logging("\nConfiguration imported (took %.3e sec)!\n", t2 - t1);
 }
 #elif (MASTER_FIELD == 1)
-void readConfig(char *infile, int nstart)
+int readConfigSublattice(char *infile, double *f, int n_sl)
 {
-    FILE *fin = NULL;
-    int ii, in, iend;
-    long int icheck, icheck2;
-    long int pos;
-    int ileng_mf[DIM];
-    stdint_t info[2], lscheck_mf[DIM];
-    // double plaq, plaq0, eps;
-    double *zw, *buff = NULL;
-    double t1, t2;
+    int npiece;
+    char *skip = NULL;
 
-    checkpoint("read_config -- in");
-    logging("\nReading configuration %s at position %d:\n", infile, nstart);
-    t1 = getTime();
+    error(f == NULL, "read_config [config_IO.c]", "Fields are not allocated!");
 
-/*added master-field extents*/
-#if (DIM == 2)
-    ileng_mf[0] = LENGT_MF;
-    ileng_mf[1] = LENGS1_MF;
-#elif (DIM == 3)
-    ileng_mf[0] = LENGT_MF;
-    ileng_mf[1] = LENGS1_MF;
-    ileng_mf[2] = LENGS2_MF;
-#elif (DIM == 4)
-    ileng_mf[0] = LENGT_MF;
-    ileng_mf[1] = LENGS1_MF;
-    ileng_mf[2] = LENGS2_MF;
-    ileng_mf[3] = LENGS3_MF;
+#if (MF_HALO_CACHE > 0)
+    skip = calloc(VOL2, sizeof(char));
+    error(skip == NULL, "read_config [config_IO.c]", "Unable to allocate buffers!");
+#pragma omp critical(mf_cache)
+    fetchHalo(infile, f, n_sl, skip);
 #endif
 
-    error(pu[0][0] == NULL, "read_config [config_IO.c]", "Fields are not allocated!");
+#if (MF_IO_MMAP == 1)
+    char *m;
 
-    iend = endianness();
-    icheck = 0;
+#pragma omp critical(config_IO)
+    m = mapConfig(infile, 0);
+    npiece = transferSites(NULL, m, MF_FILE_LAYOUT, MF_VERSION, f, n_sl, 0, skip);
+    /* the sublattices are visited in order, prefetch the next one */
+    adviseBlock(n_sl + 1, MADV_WILLNEED);
+#else
+    FILE *fin = NULL;
 
     fin = fopen(infile, "rb");
     error(fin == NULL, "read_config [config_IO.c]", "Unable to read input file %s!", infile);
-    icheck = fread(info, sizeof(stdint_t), 2, fin);
-    icheck += fread(lscheck_mf, sizeof(stdint_t), DIM, fin); /*added master_field extent values*/
-    // icheck += fread(&plaq0, sizeof(double), 1, fin);
+    checkHeader(fin, MF_FILE_LAYOUT, 0);
 
-    if (iend == BIG_ENDIAN)
-    {
-        bswap_int(2, info);
-        bswap_int(DIM, lscheck_mf); /*mf*/
-        // bswap_double(1, &plaq0);
-    }
-    // check 2 statt 3 wegen plaq
-    error(icheck != DIM + 2, "read_config [config_IO.c]", "Read error! (Master-field)");
-    error((info[0] != DIM) || (info[1] != SUN), "read_config [config_IO.c]", "Incompatible parameters!");
-    for (ii = 0; ii < DIM; ii++)
-    {
-        error(lscheck_mf[ii] != ileng_mf[ii], "read_config [config_IO.c]", "Incompatible master_field size!"); /*added master-field size check*/
-    }
-
-    buff = malloc(SUNVOL * DIM * sizeof(double));
-    error(buff == NULL, "read_config [config_IO.c]", "Unable to allocate buffers!");
+    npiece = transferSites(fin, NULL, MF_FILE_LAYOUT, MF_VERSION, f, n_sl, 0, skip);
 
-    icheck = 0;
-
-    // offset_header = ftell(fin);
-
-    for (in = 0; in < VOL2; in++)
-    {
-        pos = index_mf[in];
-        pos *= (long int)(SUNVOL * DIM * sizeof(double));
-        fseek(fin, offset_header + pos, SEEK_SET); // TODO
-        icheck += fread(buff, sizeof(double), SUNVOL * DIM, fin);
-        if (iend == BIG_ENDIAN)
-        {
-            bswap_double(SUNVOL * DIM, buff);
-        }
-
-        for (ii = 0, zw = buff; ii < DIM; ii++, zw += SUNVOL)
-            mk_dble_array_sun(zw, *pu[in][ii]);
-    }
+    fclose(fin);
+#endif
+    free(skip);
 
-    icheck2 = DIM * SUNVOL * VOL2;
-    error(icheck != icheck2, "read_config [config_IO.c]", "Read error!");
+    return npiece;
+}
 
-    fclose(fin);
+void readConfig(char *infile, int nstart)
+{
+    int npiece;
+    double t1, t2;
 
-    // plaq = plaquette();
-    // eps = sqrt((double)(NPLAQ * VOL)) * DBL_EPSILON;
-    // error(fabs(plaq - plaq0) > eps, "read_config [config_IO.c]", "Plaquette test failed!");
+    checkpoint("read_config -- in");
+    logging("\nReading configuration %s at position %d:\n", infile, nstart);
+    t1 = getTime();
 
-    free(buff);
+    npiece = readConfigSublattice(infile, pu, nstart);
+    puSublattice = nstart;
 
     checkpoint("read_config -- out");
     t2 = getTime();
-    logging("\nConfiguration imported (took %.3e sec)!\n", t2 - t1);
+    logging("\nConfiguration imported in %d pieces (took %.3e sec)!\n", npiece, t2 - t1);
 }
 
 #endif
\ No newline at end of file
@@ -21,7 +21,9 @@
  *      also pased back to the calling routine (typically the main) via
  *      the arguments of the function.
  *
- *      For parameters in runParameters see the documentation.
+ *      For parameters in runParameters see the documentation. The fields
+ *      after seed are optional and may be given in any order, their
+ *      defaults are nover=0, nlocal=1 and mfshift=0.
  *      iseed : seed for random number generator
  *      dir: directory for output
  *      rconf: Start from a given configuration?
@@ -33,12 +35,17 @@
  *      id: run id
  *      dir: output diectory
  *
+ *      With MPI_PARALLEL 1 the files are created by the process with rank 0.
+ *      The log files of the other processes, which only receive their error
+ *      messages, get the rank as additional extension.
+ *
  * void printStartupInfo(int iseed,int rconf,char *cfile)
  *      Printing the startup information into the logfile. for identification
  *      of run parameters etc..
  *
  *      iseed: seed of randum number generator
  *      rconf,cfile: as above
+ *      With MPI_PARALLEL 1 only the process with rank 0 writes.
  *
  *******************************************************************************/
 
@@ -50,19 +57,28 @@
 #include <dirent.h>
 #include <errno.h>
 #include "modules.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 void readInputFile(int *iseed, char *dir, int *rconf, char *cfile, int argc, char *argv[])
 {
     FILE *inf = NULL, *ftest = NULL;
     int i, ii, ifail = 0;
-    int id, nconf, nstep, ntherm, wcnfg;
+    int id, nconf, nstep, ntherm, wcnfg, nover, nlocal, mfshift;
     double beta, eps;
+    char line[NAME_SIZE], key[32];
 
-    ftest = fopen("SETUP_ERRORS", "r");
-    if (ftest != NULL)
+#if (MPI_PARALLEL == 1)
+    if (mpiRank() == 0)
+#endif
     {
-        fclose(ftest);
-        remove("SETUP_ERRORS");
+        ftest = fopen("SETUP_ERRORS", "r");
+        if (ftest != NULL)
+        {
+            fclose(ftest);
+            remove("SETUP_ERRORS");
+        }
     }
     sprintf(LOG_FILE, "SETUP_ERRORS");
 
@@ -104,6 +120,26 @@ void readInputFile(int *iseed, char *dir, int *rconf, char *cfile, int argc, cha
     error(ifail != 9, "readInputFile [inp_IO.c]",
           "Unable to read some fields in input file");
 
+    /* the remaining fields are optional and may be given in any order */
+    nover = 0;
+    nlocal = 1;
+    mfshift = 0;
+    while (fgets(line, sizeof(line), inf) != NULL)
+    {
+        if (sscanf(line, "%31s", key) != 1)
+            continue;
+        if (strcmp(key, "nover") == 0)
+            ifail = sscanf(line, "%*s %d", &nover);
+        else if (strcmp(key, "nlocal") == 0)
+            ifail = sscanf(line, "%*s %d", &nlocal);
+        else if (strcmp(key, "mfshift") == 0)
+            ifail = sscanf(line, "%*s %d", &mfshift);
+        else
+            ifail = 0;
+        error(ifail != 1, "readInputFile [inp_IO.c]",
+              "Unknown or incomplete field in input file");
+    }
+
     fclose(inf);
 
     runParams.idForOutputFilesName = id;
@@ -113,6 +149,9 @@ void readInputFile(int *iseed, char *dir, int *rconf, char *cfile, int argc, cha
     runParams.decorSteps = nstep;
     runParams.numThermConfs = ntherm;
     runParams.writeConfsFreq = wcnfg;
+    runParams.numOverrelax = nover;
+    runParams.numLocalSweeps = nlocal;
+    runParams.mfShift = mfshift;
 }
 
 void setupOutputFiles(int id, char *dir)
@@ -138,6 +177,16 @@ void setupOutputFiles(int id, char *dir)
 #endif
 #endif
 
+#if (MPI_PARALLEL == 1)
+    if (mpiRank() != 0)
+    {
+        sprintf(LOG_FILE, "%s/%s.log.%d", dir, base, mpiRank());
+        sprintf(OUT_FILE, "%s/%s.out", dir, base);
+        sprintf(CNFG_FILE, "%s/%s", dir, base);
+        return;
+    }
+#endif
+
     sprintf(check, "%s/%s.log", dir, base);
     fset = fopen(check, "r");
     error(fset != NULL, "setupOutputFiles [inp_IO.c]",
@@ -173,6 +222,10 @@ void printStartupInfo(int iseed, int rconf, char *cfile)
 {
     FILE *flog = NULL;
 
+#if (MPI_PARALLEL == 1)
+    if (mpiRank() != 0)
+        return;
+#endif
     flog = fopen(LOG_FILE, "ab");
     error(flog == NULL, "printStartupInfo [inp_IO.c]",
           "Unable to open .log file!");
@@ -218,7 +271,18 @@ void printStartupInfo(int iseed, int rconf, char *cfile)
     fprintf(flog, "ndecorr :\t%d\n", runParams.decorSteps);
     fprintf(flog, "ntherm :\t%d\n", runParams.numThermConfs);
     fprintf(flog, "writeConfFreq :\t%d\n", runParams.writeConfsFreq);
+    fprintf(flog, "nover :\t%d\n", runParams.numOverrelax);
+#if (MASTER_FIELD == 1)
+    fprintf(flog, "nlocal :\t%d\n", runParams.numLocalSweeps);
+    fprintf(flog, "mfshift :\t%d\n", runParams.mfShift);
+#endif
     fprintf(flog, "seed :\t%d\n", iseed);
+#ifdef _OPENMP
+    fprintf(flog, "threads :\t%d\n", omp_get_max_threads());
+#endif
+#if (MPI_PARALLEL == 1)
+    fprintf(flog, "processes :\t%d\n", mpiSize());
+#endif
     fprintf(flog, "*******************************\n");
     fprintf(flog, "Inline measurements:\n");
     fprintf(flog, "None at the moment!\n");
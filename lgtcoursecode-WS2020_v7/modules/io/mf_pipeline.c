@@ -0,0 +1,231 @@
+
+/*******************************************************************************
+ *
+ * File mf_pipeline.c
+ *
+ * This software is distributed under the terms of the GNU General Public
+ * License (GPL)
+ *
+ * Includes the pipelined master-field sweep, where the sublattices are read
+ * and written by a separate I/O thread while the current sublattice is
+ * updated.
+ *
+ * Externally accessible functions:
+ *
+ * void initMasterFieldPipeline(void)
+ *      Allocates the two additional sublattice gauge fields of the
+ *      pipeline. The standard gauge field pu must be allocated.
+ *
+ * void releaseMasterFieldPipeline(void)
+ *      Frees the fields allocated by initMasterFieldPipeline. The standard
+ *      gauge field is left allocated.
+ *
+ * double masterFieldSweepPipelined(char *cnfg_file, int iup, int nup)
+ *      Performs gaugefieldUpdate(iup,nup,SIM_TYPE,SWEEP_TYPE) on all VOL_SL
+ *      sublattices of the master field stored in cnfg_file and returns the
+ *      plaquette of the master field after the sweep (see trackedPlaquette
+ *      in update.c). While sublattice k is updated, the I/O thread writes
+ *      sublattice k-1 back to the file and then reads sublattice k+1. The
+ *      outer layers of sublattice k+1 that belong to the core of sublattice
+ *      k are afterwards copied from sublattice k in memory, all other outer
+ *      layers belong to sublattices that have been written before. The
+ *      result is thus identical to the one of the sequential loop over
+ *      readConfig, gaugefieldUpdate and writeConfig, also for a shifted
+ *      sublattice grid (see shiftMasterField in init.c). On return pu holds
+ *      the last sublattice.
+ *
+ *******************************************************************************/
+
+#define MF_PIPELINE_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "headers.h"
+#include "modules.h"
+
+#if (MASTER_FIELD == 1)
+
+#define NBUF 3
+
+static int init = 0, base = 0;
+static double *buf[NBUF];
+
+/* buffer of sublattice k */
+#define slot(k) ((base + (k)) % NBUF)
+
+typedef struct
+{
+    char *file;
+    int kw, kr;
+    double time;
+} io_task;
+
+static void *ioThread(void *arg)
+{
+    io_task *task = arg;
+    double t1;
+
+    t1 = getTime();
+    if (task->kw >= 0)
+        writeConfigSublattice(task->file, buf[slot(task->kw)], task->kw);
+    if (task->kr >= 0)
+        readConfigSublattice(task->file, buf[slot(task->kr)], task->kr);
+    task->time = getTime() - t1;
+
+    return NULL;
+}
+
+/* copies the links of the outer layers of sublattice k+1 which lie in the
+ * core of sublattice k from the field of sublattice k */
+static void copyHaloFromPrevious(int k)
+{
+    int n, jn, dir, off, c;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], x[DIM];
+    int xk[LSUM2], xk1[LSUM2];
+    double *f0, *f1;
+    sun_mat u;
+
+    f0 = buf[slot(k)];
+    f1 = buf[slot(k + 1)];
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+    masterFieldCoordinates(k, xk);
+    masterFieldCoordinates(k + 1, xk1);
+
+    for (dir = 0; dir < DIM; dir++)
+        x[dir] = 0;
+    for (n = 0; n < VOL2; n++)
+    {
+        /* normal index on sublattice k, whose origin is at xk[off+1], the
+         * cores wrap around the master field if the grid is shifted */
+        jn = 0;
+        for (dir = 0, off = 0; dir < DIM; off += latticeExtent[dir] + 2, dir++)
+        {
+            c = (xk1[off + x[dir]] - xk[off + 1] + latticeExtent_mf[dir]) % latticeExtent_mf[dir];
+            if ((c < 0) || (c >= latticeExtent[dir]))
+                break;
+            jn = jn * latticeExtent[dir] + c;
+        }
+
+        if (dir == DIM)
+        {
+            for (dir = 0; dir < DIM; dir++)
+            {
+                gf_get(u, f0, i[jn], dir);
+                gf_set(f1, n, dir, u);
+            }
+        }
+
+        for (dir = DIM - 1; dir >= 0; dir--)
+        {
+            if (x[dir] + 1 < latticeExtent[dir] + 2)
+            {
+                x[dir]++;
+                break;
+            }
+            x[dir] = 0;
+        }
+    }
+}
+
+void initMasterFieldPipeline(void)
+{
+    int ib;
+
+    checkpoint("initMasterFieldPipeline -- in");
+
+    error(init != 0, "initMasterFieldPipeline [mf_pipeline.c]",
+          "Pipeline already initialised!");
+    error(pu == NULL, "initMasterFieldPipeline [mf_pipeline.c]",
+          "Gauge field is not allocated!");
+
+    buf[0] = pu;
+    for (ib = 1; ib < NBUF; ib++)
+        allocateGaugeField(&buf[ib]);
+    init = 1;
+
+    checkpoint("initMasterFieldPipeline -- out");
+}
+
+void releaseMasterFieldPipeline(void)
+{
+    int ib;
+
+    checkpoint("releaseMasterFieldPipeline");
+
+    error(init == 0, "releaseMasterFieldPipeline [mf_pipeline.c]",
+          "Pipeline not initialised!");
+
+    for (ib = 0; ib < NBUF; ib++)
+    {
+        if (buf[ib] != pu)
+            deallocateGaugeField(&buf[ib]);
+    }
+    init = 0;
+}
+
+double masterFieldSweepPipelined(char *cnfg_file, int iup, int nup)
+{
+    int k, ifail;
+    double t1, t2, tio, twait;
+    pthread_t tid;
+    io_task task;
+
+    checkpoint("masterFieldSweepPipelined -- in");
+
+    error(init == 0, "masterFieldSweepPipelined [mf_pipeline.c]",
+          "Pipeline not initialised!");
+    t1 = getTime();
+
+    /* start with the buffer in pu, its sublattice has been written back */
+    for (base = 0; base < NBUF; base++)
+    {
+        if (buf[base] == pu)
+            break;
+    }
+    error(base == NBUF, "masterFieldSweepPipelined [mf_pipeline.c]",
+          "Gauge field pu is not a pipeline buffer!");
+
+    task.file = cnfg_file;
+    task.kw = -1;
+    task.kr = 0;
+    ioThread(&task);
+    tio = task.time;
+    twait = task.time;
+
+    for (k = 0; k < VOL_SL; k++)
+    {
+        task.kw = k - 1;
+        task.kr = (k + 1 < VOL_SL) ? (k + 1) : (-1);
+        ifail = pthread_create(&tid, NULL, ioThread, &task);
+        error(ifail != 0, "masterFieldSweepPipelined [mf_pipeline.c]",
+              "Unable to start the I/O thread!");
+
+        pu = buf[slot(k)];
+        puSublattice = k;
+        gaugefieldUpdate(iup, nup, SIM_TYPE, SWEEP_TYPE);
+
+        t2 = getTime();
+        pthread_join(tid, NULL);
+        twait += getTime() - t2;
+        tio += task.time;
+
+        if (task.kr >= 0)
+            copyHaloFromPrevious(k);
+    }
+
+    task.kw = VOL_SL - 1;
+    task.kr = -1;
+    t2 = getTime();
+    ioThread(&task);
+    twait += getTime() - t2;
+    tio += task.time;
+
+    checkpoint("masterFieldSweepPipelined -- out");
+    logging("\nPipelined master-field sweep took %.3e sec (I/O thread %.3e sec, waited %.3e sec)\n",
+            getTime() - t1, tio, twait);
+
+    return trackedPlaquette();
+}
+
+#endif
@@ -23,6 +23,10 @@ static int init=0;
 static int nsource;
 static sun_wferm *s,*f1,*f2;
 static sun_wferm **d;
+#if (SOLVER_TYPE == 2)
+static int *niter;
+static sun_wferm **sb;
+#endif
 
 
 
@@ -116,6 +120,13 @@ void allocateFermionFieldsFor2ptFunctions(int stype)
    d=malloc(nsource*sizeof(sun_wferm*));
    for(ii=0;ii<nsource;ii++)
       allocateFermionField(d+ii);
+#if (SOLVER_TYPE == 2)
+   sb=malloc(nsource*sizeof(sun_wferm*));
+   niter=malloc(nsource*sizeof(int));
+   for(ii=0;ii<nsource;ii++)
+      allocateFermionField(sb+ii);
+   allocateFermionFieldsForBlockCG(nsource);
+#endif
 
    allocateFermionFieldsForCG();
    init=1;
@@ -130,6 +141,13 @@ void deallocateFermionFieldsFor2ptFunctions(void)
 
    for(ii=0;ii<nsource;ii++)
       deallocateFermionField(d+ii);
+#if (SOLVER_TYPE == 2)
+   for(ii=0;ii<nsource;ii++)
+      deallocateFermionField(sb+ii);
+   free(sb);
+   free(niter);
+   deallocateFermionFieldsForBlockCG();
+#endif
 
    deallocateFermionField(&s);
    deallocateFermionField(&f1);
@@ -147,20 +165,43 @@ void measure2ptFunctions(int *source,int stype,int n2pt,int *g1,int *g2)
    error(init==0,"meas_2pt [2pt.c]","Has not been initialised!");
 
    t1=getTime();
+#if (SOLVER_TYPE == 2)
+   for(ii=0;ii<nsource;ii++)
+   {
+      if(stype==1)
+         pointSource(sb[ii],n,ii);
+      setAllSpinorsToZero(d[ii]);
+   }
+
+   tt1=getTime();
+   test=bcg_eo(d,sb,nsource,measParams.eps,measParams.nmax,niter);
+   tt2=getTime();
+   for(ii=0;ii<nsource;ii++)
+   {
+      error(niter[ii]<0,"test","Inversion %d failed!",ii);
+      logging("Inversion %d: %d iterations\n",ii,niter[ii]);
+   }
+   logging("Block inversion: %d iterations; took %.3f sec\n",test,tt2-tt1);
+#else
    for(ii=0;ii<nsource;ii++)
    {
       if(stype==1)
          pointSource(s,n,ii);
       setAllSpinorsToZero(f1);
-      applyComplexConjDiracOperator(f2,s);
 
       tt1=getTime();
+#if (SOLVER_TYPE == 1)
+      test=cg_eo(f1,s,measParams.eps,measParams.nmax);
+#else
+      applyComplexConjDiracOperator(f2,s);
       test=cg(f1,applyWilsonDiracOperator,applyComplexConjDiracOperator,f2,measParams.eps,measParams.nmax);
+#endif
       tt2=getTime();
       error(test<0,"test","Inversion %d failed!",ii);
       logging("Inversion %d: %d iterations; took %.3f sec\n",ii,test,tt2-tt1);
       copySpinors(d[ii],f1);
    }
+#endif
 
    ch=malloc(nsource*sizeof(complex*));
    for(ii=0;ii<nsource;ii++)
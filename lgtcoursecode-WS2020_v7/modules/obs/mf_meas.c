@@ -0,0 +1,245 @@
+
+/*******************************************************************************
+ *
+ * File mf_meas.c
+ *
+ * This software is distributed under the terms of the GNU General Public
+ * License (GPL)
+ *
+ * Includes the measurement of observables on a master field stored in a
+ * file, without updating it.
+ *
+ * Externally accessible functions:
+ *
+ * double measureMasterField(char *cnfg_file, double *tprof, double *ploop)
+ *      Reads the master field stored in cnfg_file once, sublattice by
+ *      sublattice in the order of the file, and returns the average
+ *      plaquette of the master field. Every plaquette is counted at the
+ *      core point at which it starts, its other links are taken from the
+ *      outer layers, so the plaquettes across the sublattice boundaries
+ *      are included. tprof[t] is set to the Wilson action density
+ *      beta*sum_{mu<nu}(1-Re tr P_{mu nu}(x)/N) averaged over the time slice
+ *      t of the master field (LENGT_MF entries). ploop[0] and ploop[1] are
+ *      set to the real and imaginary part of the Polyakov loop tr(P)/N
+ *      averaged over the spatial points of the master field, ploop[2] to
+ *      the average of |tr(P)/N|^2. The temporal line products are carried
+ *      from one sublattice to the next one in time direction, which
+ *      follows later in the file. The next sublattice is read by a
+ *      separate I/O thread while the current one is measured. The sums are
+ *      taken over the blocks of points of spin_alg.c and added in a fixed
+ *      order. The sublattice grid must not be shifted.
+ *
+ *******************************************************************************/
+
+#define MF_MEAS_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "headers.h"
+#include "modules.h"
+
+#if (MASTER_FIELD == 1)
+
+/* number of spatial points of a sublattice and of the master field */
+#define NSPACE (VOL / LENGT)
+#define NSPACE_MF (VOL_MF / LENGT_MF)
+
+typedef struct
+{
+    char *file;
+    double *f;
+    int kr;
+    double time;
+} read_task;
+
+static void *readThread(void *arg)
+{
+    read_task *task = arg;
+    double t1;
+
+    t1 = getTime();
+    readConfigSublattice(task->file, task->f, task->kr);
+    task->time = getTime() - t1;
+
+    return NULL;
+}
+
+/* Returns the sum of Re tr of the plaquettes starting at the point in of
+ * the bigger lattice */
+static double plaquetteSum(double *f, int in)
+{
+    int jj, kk, n;
+    double plaq, tr;
+    sun_mat un[3], u;
+
+    plaq = 0.;
+    for (jj = 0; jj < (DIM - 1); jj++)
+    {
+        for (kk = jj + 1; kk < DIM; kk++)
+        {
+            gf_get(un[0], f, in, jj);
+            n = neib[in][jj];
+            gf_get(un[1], f, n, kk);
+            sun_mul(un[2], un[0], un[1]);
+            n = neib[in][kk];
+            gf_get(u, f, n, jj);
+            sun_dag(un[0], u);
+            sun_mul(un[1], un[2], un[0]);
+            gf_get(u, f, in, kk);
+            sun_dag(un[2], u);
+            sun_mul(un[0], un[1], un[2]);
+            sun_trace(tr, un[0]);
+            plaq += tr;
+        }
+    }
+
+    return plaq;
+}
+
+/* Adds the plaquettes of the core of sublattice n_sl, stored in f, to the
+ * time slices tsum of the master field and multiplies its temporal links to
+ * the line products. bsum holds reductionBlocks()*LENGT partial sums. */
+static void measureSublattice(double *f, int n_sl, double *tsum, double *bsum, sun_mat *line)
+{
+    int b, t, nb = reductionBlocks();
+    int latticeExtent[DIM], latticeExtent_mf[DIM], xmf[LSUM2];
+
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+    masterFieldCoordinates(n_sl, xmf);
+
+#pragma omp parallel for schedule(static)
+    for (b = 0; b < nb; b++)
+    {
+        int sp, js, tt, dir, off, m, n, in;
+        int x[DIM];
+        sun_mat u, v;
+
+        for (tt = 0; tt < LENGT; tt++)
+            bsum[b * LENGT + tt] = 0.;
+
+        for (sp = red_block_start(b, nb, NSPACE); sp < red_block_start(b + 1, nb, NSPACE); sp++)
+        {
+            /* spatial index on the master field, the last direction runs fastest */
+            for (dir = DIM - 1, m = sp; dir > 0; dir--)
+            {
+                x[dir] = m % latticeExtent[dir];
+                m /= latticeExtent[dir];
+            }
+            js = 0;
+            for (dir = 1, off = latticeExtent[0] + 2; dir < DIM; off += latticeExtent[dir] + 2, dir++)
+                js = js * latticeExtent_mf[dir] + xmf[off + x[dir] + 1];
+
+            for (tt = 0; tt < LENGT; tt++)
+            {
+                n = tt * NSPACE + sp;
+                in = i[n];
+                bsum[b * LENGT + tt] += plaquetteSum(f, in);
+
+                gf_get(u, f, in, 0);
+                v = line[js];
+                sun_mul(line[js], v, u);
+            }
+        }
+    }
+
+    /* blocks and sublattices are added in a fixed order */
+    for (t = 0; t < LENGT; t++)
+    {
+        for (b = 0; b < nb; b++)
+            tsum[xmf[t + 1]] += bsum[b * LENGT + t];
+    }
+}
+
+double measureMasterField(char *cnfg_file, double *tprof, double *ploop)
+{
+    int k, t, js, ifail;
+    double plaq, *tsum, *bsum, *buf[2];
+    double t1, t2, tio, twait, p2;
+    complex tr, sum;
+    sun_mat *line;
+    pthread_t tid;
+    read_task task;
+
+    checkpoint("measureMasterField -- in");
+
+    error(masterFieldShifted(), "measureMasterField [mf_meas.c]",
+          "The sublattice grid must not be shifted!");
+    t1 = getTime();
+
+    tsum = calloc(LENGT_MF, sizeof(double));
+    bsum = malloc(reductionBlocks() * LENGT * sizeof(double));
+    line = malloc(NSPACE_MF * sizeof(sun_mat));
+    error((tsum == NULL) || (bsum == NULL) || (line == NULL), "measureMasterField [mf_meas.c]",
+          "Unable to allocate buffers!");
+    allocateGaugeField(&buf[0]);
+    allocateGaugeField(&buf[1]);
+
+    for (js = 0; js < NSPACE_MF; js++)
+        sun_unit(line[js]);
+
+    task.file = cnfg_file;
+    task.f = buf[0];
+    task.kr = 0;
+    readThread(&task);
+    tio = task.time;
+    twait = task.time;
+
+    for (k = 0; k < VOL_SL; k++)
+    {
+        if (k + 1 < VOL_SL)
+        {
+            task.f = buf[(k + 1) % 2];
+            task.kr = k + 1;
+            ifail = pthread_create(&tid, NULL, readThread, &task);
+            error(ifail != 0, "measureMasterField [mf_meas.c]",
+                  "Unable to start the I/O thread!");
+        }
+
+        measureSublattice(buf[k % 2], k, tsum, bsum, line);
+
+        if (k + 1 < VOL_SL)
+        {
+            t2 = getTime();
+            pthread_join(tid, NULL);
+            twait += getTime() - t2;
+            tio += task.time;
+        }
+    }
+
+    plaq = 0.;
+    for (t = 0; t < LENGT_MF; t++)
+    {
+        plaq += tsum[t];
+        tprof[t] = runParams.beta * (NPLAQ - tsum[t] / (double)(SUN * NSPACE_MF));
+    }
+    plaq /= (double)(SUN * NPLAQ) * (double)(VOL_MF);
+
+    sum.re = 0.;
+    sum.im = 0.;
+    p2 = 0.;
+    for (js = 0; js < NSPACE_MF; js++)
+    {
+        sun_trace_cl(tr, line[js]);
+        sum.re += tr.re / SUN;
+        sum.im += tr.im / SUN;
+        p2 += (tr.re * tr.re + tr.im * tr.im) / (SUN * SUN);
+    }
+    ploop[0] = sum.re / NSPACE_MF;
+    ploop[1] = sum.im / NSPACE_MF;
+    ploop[2] = p2 / NSPACE_MF;
+
+    deallocateGaugeField(&buf[0]);
+    deallocateGaugeField(&buf[1]);
+    free(line);
+    free(bsum);
+    free(tsum);
+
+    checkpoint("measureMasterField -- out");
+    logging("\nMaster-field measurement took %.3e sec (I/O thread %.3e sec, waited %.3e sec)\n",
+            getTime() - t1, tio, twait);
+
+    return plaq;
+}
+
+#endif
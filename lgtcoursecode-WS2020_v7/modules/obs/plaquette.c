@@ -12,11 +12,12 @@
  *
  * double plaquette(void)
  *      Returns the average value of the plaquette on the gauge field
- *      configuration.
+ *      configuration. With MPI_PARALLEL 1 the average is taken over the
+ *      lattices of all processes.
  *
  * double gaugeAction(void)
  *      Returns the Wilson gauge action measured on the gauge field
- *      configuration.
+ *      configuration (on all processes with MPI_PARALLEL 1).
  *******************************************************************************/
 
 #define PLAQUETTE_C
@@ -32,7 +33,7 @@ double plaquette(void)
 {
     int ii, jj, kk, n;
     double plaq, tr;
-    sun_mat *un;
+    sun_mat *un, u;
 
     checkpoint("plaquette");
 
@@ -44,21 +45,27 @@ double plaquette(void)
         {
             for (kk = jj + 1; kk < DIM; kk++)
             {
-                un[0] = *pu[i[ii]][jj];
+                gf_get(un[0], pu, i[ii], jj);
                 n = neib[i[ii]][jj];
-                un[1] = *pu[n][kk];
+                gf_get(un[1], pu, n, kk);
                 sun_mul(un[2], un[0], un[1]);
                 n = neib[i[ii]][kk];
-                sun_dag(un[0], *pu[n][jj]);
+                gf_get(u, pu, n, jj);
+                sun_dag(un[0], u);
                 sun_mul(un[1], un[2], un[0]);
-                sun_dag(un[2], *pu[i[ii]][kk]);
+                gf_get(u, pu, i[ii], kk);
+                sun_dag(un[2], u);
                 sun_mul(un[0], un[1], un[2]);
                 sun_trace(tr, un[0]);
                 plaq += tr;
             }
         }
     }
+#if (MPI_PARALLEL == 1)
+    plaq = mpiGlobalSum(plaq) / ((double)(SUN * NPLAQ * VOL) * VOL_SL);
+#else
     plaq /= (double)(SUN * NPLAQ * VOL);
+#endif
     free(un);
 
     return plaq;
@@ -68,7 +75,7 @@ double plaquette(void)
 {
     int ii, jj, kk, n;
     double plaq, tr;
-    sun_mat *un;
+    sun_mat *un, u;
 
     checkpoint("plaquette");
 
@@ -80,14 +87,16 @@ double plaquette(void)
         {
             for (kk = jj + 1; kk < DIM; kk++)
             {
-                un[0] = *pu[ii][jj];
+                gf_get(un[0], pu, ii, jj);
                 n = neib[ii][jj];
-                un[1] = *pu[n][kk];
+                gf_get(un[1], pu, n, kk);
                 sun_mul(un[2], un[0], un[1]);
                 n = neib[ii][kk];
-                sun_dag(un[0], *pu[n][jj]);
+                gf_get(u, pu, n, jj);
+                sun_dag(un[0], u);
                 sun_mul(un[1], un[2], un[0]);
-                sun_dag(un[2], *pu[ii][kk]);
+                gf_get(u, pu, ii, kk);
+                sun_dag(un[2], u);
                 sun_mul(un[0], un[1], un[2]);
                 sun_trace(tr, un[0]);
                 plaq += tr;
@@ -106,5 +115,9 @@ double gaugeAction(void)
     double plaq;
 
     plaq = plaquette();
+#if (MPI_PARALLEL == 1)
+    return runParams.beta * NPLAQ * VOL * VOL_SL * (1. - plaq);
+#else
     return runParams.beta * NPLAQ * VOL * (1. - plaq);
+#endif
 }
@@ -12,13 +12,13 @@
 * 
 * Externally accessible functions:
 * 
-* void smearing_APE_spatial(int ns,double sp,sun_mat *u[VOL][DIM])
+* void smearing_APE_spatial(int ns,double sp,double *u)
 *      Performs ns smearing levels of APE smearing for the spatial
 *      links included in the gauge field u. Note, in the course
 *      of the smearing no temporal staples are used. The smearing
 *      parameter is handed over to the routine in sp.
 * 
-* void smearing_APE_temporal(int ns,double sp,sun_mat *u[VOL][DIM])
+* void smearing_APE_temporal(int ns,double sp,double *u)
 *      Performs ns smearing levels of APE smearing for the temporal
 *      links included in the gauge field u. Note, in the course
 *      of the smearing no spatial links are changed. The smearing
@@ -33,13 +33,13 @@
 #include"modules.h"
 
 static int init=0;
-static sun_mat *zu[VOL][DIM];
+static double *zu;
 
 
 static void staples_smearing(int n,int dir,int dt,sun_mat *stap)
 {
    int kk,n1,n2;
-   sun_mat un[4];
+   sun_mat un[4],u1,u2,u3;
 
    sun_zero(un[3]);
 
@@ -50,16 +50,22 @@ static void staples_smearing(int n,int dir,int dt,sun_mat *stap)
          n1=neib[n][dir];
          n2=neib[n][kk];
 
-         sun_mul(un[1],*zu[n][kk],*zu[n2][dir]);
-         sun_mul_dag(un[0],un[1],*zu[n1][kk]);
+         gf_get(u1,zu,n,kk);
+         gf_get(u2,zu,n2,dir);
+         gf_get(u3,zu,n1,kk);
+         sun_mul(un[1],u1,u2);
+         sun_mul_dag(un[0],un[1],u3);
          sun_add(un[2],un[3],un[0]);
 
          n2=neib[n][kk+DIM];
          n1=neib[n2][dir];
 
-         sun_dag(un[0],*zu[n2][kk]);
-         sun_mul(un[1],un[0],*zu[n2][dir]);
-         sun_mul(un[0],un[1],*zu[n1][kk]);
+         gf_get(u1,zu,n2,kk);
+         gf_get(u2,zu,n2,dir);
+         gf_get(u3,zu,n1,kk);
+         sun_dag(un[0],u1);
+         sun_mul(un[1],un[0],u2);
+         sun_mul(un[0],un[1],u3);
          sun_add(un[3],un[2],un[0]);
       }
    }
@@ -69,14 +75,14 @@ static void staples_smearing(int n,int dir,int dt,sun_mat *stap)
 
 
 
-void smearing_APE_spatial(int ns,double sp,sun_mat *u[VOL][DIM])
+void smearing_APE_spatial(int ns,double sp,double *u)
 {
    int ii,jj,n;
-   sun_mat stap;
+   sun_mat stap,v;
 
    if(init==0)
    {
-      allocateGaugeField(zu);
+      allocateGaugeField(&zu);
       init=1;
    }
 
@@ -89,27 +95,29 @@ void smearing_APE_spatial(int ns,double sp,sun_mat *u[VOL][DIM])
          {
             staples_smearing(ii,jj,0,&stap);
             sun_dble_mul(stap,sp/(2*(DIM-2)));
-            sun_dble_mul(*u[ii][jj],1.-sp);
-            sun_add(*u[ii][jj],*u[ii][jj],stap);
+            gf_get(v,u,ii,jj);
+            sun_dble_mul(v,1.-sp);
+            sun_add(v,v,stap);
 #if(SUN==2)
-            project_to_su2(u[ii][jj]);
+            project_to_su2(&v);
 #elif(SUN==3)
-            project_to_su3(u[ii][jj]);
+            project_to_su3(&v);
 #endif
+            gf_set(u,ii,jj,v);
          }
       }
    }
 }
 
 
-void smearing_APE_temporal(int ns,double sp,sun_mat *u[VOL][DIM])
+void smearing_APE_temporal(int ns,double sp,double *u)
 {
    int ii,n;
-   sun_mat stap;
+   sun_mat stap,v;
 
    if(init==0)
    {
-      allocateGaugeField(zu);
+      allocateGaugeField(&zu);
       init=1;
    }
    
@@ -120,13 +128,15 @@ void smearing_APE_temporal(int ns,double sp,sun_mat *u[VOL][DIM])
       {
          staples_smearing(ii,0,0,&stap);
          sun_dble_mul(stap,sp/(2*(DIM-1)));
-         sun_dble_mul(*u[ii][0],1.-sp);
-         sun_add(*u[ii][0],*u[ii][0],stap);
+         gf_get(v,u,ii,0);
+         sun_dble_mul(v,1.-sp);
+         sun_add(v,v,stap);
 #if(SUN==2)
-         project_to_su2(u[ii][0]);
+         project_to_su2(&v);
 #elif(SUN==3)
-         project_to_su3(u[ii][0]);
+         project_to_su3(&v);
 #endif
+         gf_set(u,ii,0,v);
       }
    }
 }
@@ -18,40 +18,44 @@
 #include"modules.h"
 
 static int init=0;
-static sun_mat *iu1[VOL][DIM],*iu2[VOL][DIM];
+static double *iu1,*iu2;
 
 
 static double compute_wloop(int n,int d1,int d2,int l1,int l2)
 {
    int ii,nn;
    double tr;
-   sun_mat u[2];
+   sun_mat u[2],v;
    
    sun_unit(u[0]);
    nn=n;
    for(ii=0;ii<l1;ii++)
    {
       u[1]=u[0];
-      sun_mul(u[0],u[1],*iu1[nn][d1]);
+      gf_get(v,iu1,nn,d1);
+      sun_mul(u[0],u[1],v);
       nn=neib[nn][d1];
    }
    for(ii=0;ii<l2;ii++)
    {
       u[1]=u[0];
-      sun_mul(u[0],u[1],*iu2[nn][d2]);
+      gf_get(v,iu2,nn,d2);
+      sun_mul(u[0],u[1],v);
       nn=neib[nn][d2];
    }
    for(ii=0;ii<l1;ii++)
    {
       u[1]=u[0];
       nn=neib[nn][d1+DIM];
-      sun_mul_dag(u[0],u[1],*iu1[nn][d1]);
+      gf_get(v,iu1,nn,d1);
+      sun_mul_dag(u[0],u[1],v);
    }
    for(ii=0;ii<l2;ii++)
    {
       u[1]=u[0];
       nn=neib[nn][d2+DIM];
-      sun_mul_dag(u[0],u[1],*iu2[nn][d2]);
+      gf_get(v,iu2,nn,d2);
+      sun_mul_dag(u[0],u[1],v);
    }
    
    sun_trace(tr,u[0]);
@@ -67,8 +71,8 @@ void measureWilsonLoop(double *w)
 
    if(init==0)
    {
-      allocateGaugeField(iu1);
-      allocateGaugeField(iu2);
+      allocateGaugeField(&iu1);
+      allocateGaugeField(&iu2);
       init=1;
    }
    nt=((measParams.tf-measParams.ts)/measParams.dt)+1;
@@ -0,0 +1,531 @@
+
+/*******************************************************************************
+*
+* File philox.c
+*
+* This software is distributed under the terms of the GNU General Public
+* License (GPL)
+*
+* Includes the counter-based random number generator Philox4x32-10 of
+* J. K. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" (SC11),
+* and the interface through which the updates draw their random numbers.
+*
+* Externally accessible functions:
+*
+* void initRandomStreams(int seed)
+*      Sets the key of the Philox generator to seed. All OpenMP threads and
+*      MPI processes must use the same seed.
+*
+* void randomStream(int sweep,long int site,int dir)
+*      Selects the stream (sweep,site,dir) of the calling thread and starts
+*      it from the beginning. site is the index of a point on the whole
+*      (master-field) lattice (see globalIndex in init.c), dir<DIM labels the
+*      link updates and dir>=DIM other uses of the stream. The subgroups and
+*      hits of a link update draw the following numbers of the stream.
+*
+* void randomNumbers(double r[],int n)
+*      Returns the next n random numbers of the current stream of the
+*      calling thread, uniformly distributed in [0,1), in the array r. The
+*      numbers are taken from a buffer of the thread, which is refilled
+*      with a batch of 2*PHILOX_LANES numbers at a time. Large requests are
+*      generated batch by batch directly into r.
+*
+* void randomStreamSlot(int slot,int sweep,long int site,int dir)
+*      Same as randomStream, but for the stream slot 0<=slot<RANDOM_SLOTS
+*      (see headers.h) of the calling thread. Every slot has its own
+*      buffer, so that a thread can draw from RANDOM_SLOTS streams at the
+*      same time. Slot 0 holds the current stream of randomStream.
+*
+* void randomNumbersSlot(int slot,double r[],int n)
+*      Same as randomNumbers, but for the stream in the given slot.
+*
+* void randomNumbersSlots(int ns,int slot[],double r[],int n)
+*      Returns the next n<=2*PHILOX_LANES random numbers of the streams in
+*      the ns distinct slots slot[0],..,slot[ns-1], the j-th number of
+*      slot[k] in r[j*ns+k]. The numbers are the same as those of ns calls
+*      of randomNumbersSlot, but the buffers of the slots that run empty are
+*      refilled together, PHILOX_STREAMS slots at a time.
+*
+* void philoxWords(const unsigned int k[2],const unsigned int c[4],
+*                  unsigned int x[4])
+*      Returns in x the output of Philox4x32-10 for the key k and the
+*      counter c, computed lane by lane. For the tests of the generator.
+*
+* int checkPhiloxAvx2(const unsigned int k[2],int n,unsigned int c[][4])
+*      Computes the batches of the n counters c[0],..,c[n-1] with the key k
+*      lane by lane, with philoxAvx2 and, PHILOX_STREAMS counters at a time,
+*      with philoxAvx2Streams. Returns the number of counters for which the
+*      numbers of the AVX2 functions differ bitwise from those computed lane
+*      by lane, or -1 if AVX2 is not available. The key set by
+*      initRandomStreams is restored on return. For the tests of the
+*      generator.
+*
+* With RNG_TYPE 1 (see headers.h) the j-th number of the stream
+* (sweep,site,dir) is a function of the seed, the stream and j only, namely
+* half of the 128 bit output of Philox for the counter (j/2,sweep,site,dir).
+* The configurations thus do not depend on the order in which the links
+* are updated, as long as every link is updated with its own stream. The
+* counters are processed in batches of PHILOX_LANES. On x86-64 processors
+* with AVX2 the rounds of a batch run on the four 64 bit elements of the
+* vector registers, otherwise the batch is computed lane by lane. Both give
+* the same numbers. The batches of several slots are interleaved, which
+* hides the latency of the multiplications of the rounds. The state of the
+* streams is private to every OpenMP thread. With RNG_TYPE 0 randomStream
+* does nothing and randomNumbers returns the numbers of ranlxd, initialised
+* with rlxd_init and initThreadRandomNumbers (see init.c). All slots then
+* draw from the same ranlxd generator.
+*
+*******************************************************************************/
+
+#define PHILOX_C
+
+#include <stdint.h>
+#include <string.h>
+#include "headers.h"
+#include "modules.h"
+#include "ranlxd.h"
+
+#if (RNG_TYPE == 1)
+
+#if (defined(__GNUC__)&&defined(__x86_64__))
+#include <immintrin.h>
+#define PHILOX_AVX2 1
+#else
+#define PHILOX_AVX2 0
+#endif
+
+/* four lanes fill the AVX2 registers of philoxAvx2 */
+#define PHILOX_LANES 4
+#define PHILOX_STREAMS 4
+#define PHILOX_ROUNDS 10
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+
+static uint32_t key[2]={0,0};
+static uint32_t ctr[RANDOM_SLOTS][4];
+static int left[RANDOM_SLOTS];
+static double rbuf[RANDOM_SLOTS][4*PHILOX_LANES];
+#pragma omp threadprivate(ctr,left,rbuf)
+
+
+/* Computes Philox4x32-10 with the key k for the PHILOX_LANES counters
+ * (c[0]+l,c[1],c[2],c[3]), the output of lane l in x0[l],..,x3[l] */
+static void philoxRounds(const uint32_t k[2],const uint32_t c[4],
+                         uint32_t x0[PHILOX_LANES],uint32_t x1[PHILOX_LANES],
+                         uint32_t x2[PHILOX_LANES],uint32_t x3[PHILOX_LANES])
+{
+   int l,j;
+   uint32_t k0,k1;
+   uint64_t p0,p1;
+
+   for (l=0;l<PHILOX_LANES;l++)
+   {
+      x0[l]=c[0]+(uint32_t)(l);
+      x1[l]=c[1];
+      x2[l]=c[2];
+      x3[l]=c[3];
+   }
+
+   k0=k[0];
+   k1=k[1];
+   for (j=0;j<PHILOX_ROUNDS;j++)
+   {
+      for (l=0;l<PHILOX_LANES;l++)
+      {
+         p0=(uint64_t)(PHILOX_M0)*x0[l];
+         p1=(uint64_t)(PHILOX_M1)*x2[l];
+         x0[l]=(uint32_t)(p1>>32)^x1[l]^k0;
+         x1[l]=(uint32_t)(p1);
+         x2[l]=(uint32_t)(p0>>32)^x3[l]^k1;
+         x3[l]=(uint32_t)(p0);
+      }
+      k0+=PHILOX_W0;
+      k1+=PHILOX_W1;
+   }
+}
+
+
+/* Computes Philox4x32-10 for the PHILOX_LANES counters (c[0]+l,c[1],c[2],c[3])
+ * and converts every output into two numbers in [0,1) with 53 bits */
+static void philoxGeneric(const uint32_t c[4],double r[2*PHILOX_LANES])
+{
+   int l;
+   uint32_t x0[PHILOX_LANES],x1[PHILOX_LANES],x2[PHILOX_LANES],x3[PHILOX_LANES];
+
+   philoxRounds(key,c,x0,x1,x2,x3);
+
+   for (l=0;l<PHILOX_LANES;l++)
+   {
+      r[2*l]=((double)(x0[l]>>5)*67108864.0+(double)(x1[l]>>6))*0x1.0p-53;
+      r[2*l+1]=((double)(x2[l]>>5)*67108864.0+(double)(x3[l]>>6))*0x1.0p-53;
+   }
+}
+
+
+#if (PHILOX_AVX2==1)
+
+/* The same with one counter in every 64 bit element of the AVX2 registers.
+ * Only the lower 32 bits of the elements are significant in the rounds
+ * (_mm256_mul_epu32 ignores the upper ones), which are cleared at the end.
+ * The integers are converted exactly through the mantissa of 2^52 */
+#define philoxToDouble(v,sh) \
+   _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64((v),(sh)),magic)),two52)
+
+__attribute__((target("avx2")))
+static void philoxAvx2(const uint32_t c[4],double r[2*PHILOX_LANES])
+{
+   int k;
+   __m256i x0,x1,x2,x3,p0,p1,k0,k1,m0,m1,w0,w1,lo,magic;
+   __m256d two52,s26,s53,a,b,ab0,ab1;
+
+   lo=_mm256_set1_epi64x(0xffffffffLL);
+   x0=_mm256_add_epi64(_mm256_set1_epi64x(c[0]),_mm256_set_epi64x(3,2,1,0));
+   x0=_mm256_and_si256(x0,lo);
+   x1=_mm256_set1_epi64x(c[1]);
+   x2=_mm256_set1_epi64x(c[2]);
+   x3=_mm256_set1_epi64x(c[3]);
+
+   k0=_mm256_set1_epi64x(key[0]);
+   k1=_mm256_set1_epi64x(key[1]);
+   m0=_mm256_set1_epi64x(PHILOX_M0);
+   m1=_mm256_set1_epi64x(PHILOX_M1);
+   w0=_mm256_set1_epi64x(PHILOX_W0);
+   w1=_mm256_set1_epi64x(PHILOX_W1);
+   for (k=0;k<PHILOX_ROUNDS;k++)
+   {
+      p0=_mm256_mul_epu32(m0,x0);
+      p1=_mm256_mul_epu32(m1,x2);
+      x0=_mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p1,32),x1),k0);
+      x1=p1;
+      x2=_mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p0,32),x3),k1);
+      x3=p0;
+      k0=_mm256_add_epi64(k0,w0);
+      k1=_mm256_add_epi64(k1,w1);
+   }
+   x0=_mm256_and_si256(x0,lo);
+   x1=_mm256_and_si256(x1,lo);
+   x2=_mm256_and_si256(x2,lo);
+   x3=_mm256_and_si256(x3,lo);
+
+   magic=_mm256_set1_epi64x(0x4330000000000000LL);
+   two52=_mm256_set1_pd(4503599627370496.0);
+   s26=_mm256_set1_pd(67108864.0);
+   s53=_mm256_set1_pd(0x1.0p-53);
+   a=_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(philoxToDouble(x0,5),s26),philoxToDouble(x1,6)),s53);
+   b=_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(philoxToDouble(x2,5),s26),philoxToDouble(x3,6)),s53);
+
+   /* r[2*l]=a[l], r[2*l+1]=b[l] */
+   ab0=_mm256_unpacklo_pd(a,b);
+   ab1=_mm256_unpackhi_pd(a,b);
+   _mm256_storeu_pd(r,_mm256_permute2f128_pd(ab0,ab1,0x20));
+   _mm256_storeu_pd(r+4,_mm256_permute2f128_pd(ab0,ab1,0x31));
+}
+
+/* The same for the PHILOX_STREAMS counters c[s], whose rounds are
+ * interleaved */
+__attribute__((target("avx2")))
+static void philoxAvx2Streams(uint32_t *c[PHILOX_STREAMS],double *r[PHILOX_STREAMS])
+{
+   int k,s;
+   __m256i x0[PHILOX_STREAMS],x1[PHILOX_STREAMS],x2[PHILOX_STREAMS],x3[PHILOX_STREAMS];
+   __m256i p0,p1,k0,k1,m0,m1,w0,w1,lo,magic;
+   __m256d two52,s26,s53,a,b,ab0,ab1;
+
+   lo=_mm256_set1_epi64x(0xffffffffLL);
+   for (s=0;s<PHILOX_STREAMS;s++)
+   {
+      x0[s]=_mm256_add_epi64(_mm256_set1_epi64x(c[s][0]),_mm256_set_epi64x(3,2,1,0));
+      x0[s]=_mm256_and_si256(x0[s],lo);
+      x1[s]=_mm256_set1_epi64x(c[s][1]);
+      x2[s]=_mm256_set1_epi64x(c[s][2]);
+      x3[s]=_mm256_set1_epi64x(c[s][3]);
+   }
+
+   k0=_mm256_set1_epi64x(key[0]);
+   k1=_mm256_set1_epi64x(key[1]);
+   m0=_mm256_set1_epi64x(PHILOX_M0);
+   m1=_mm256_set1_epi64x(PHILOX_M1);
+   w0=_mm256_set1_epi64x(PHILOX_W0);
+   w1=_mm256_set1_epi64x(PHILOX_W1);
+   for (k=0;k<PHILOX_ROUNDS;k++)
+   {
+      for (s=0;s<PHILOX_STREAMS;s++)
+      {
+         p0=_mm256_mul_epu32(m0,x0[s]);
+         p1=_mm256_mul_epu32(m1,x2[s]);
+         x0[s]=_mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p1,32),x1[s]),k0);
+         x1[s]=p1;
+         x2[s]=_mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p0,32),x3[s]),k1);
+         x3[s]=p0;
+      }
+      k0=_mm256_add_epi64(k0,w0);
+      k1=_mm256_add_epi64(k1,w1);
+   }
+
+   magic=_mm256_set1_epi64x(0x4330000000000000LL);
+   two52=_mm256_set1_pd(4503599627370496.0);
+   s26=_mm256_set1_pd(67108864.0);
+   s53=_mm256_set1_pd(0x1.0p-53);
+   for (s=0;s<PHILOX_STREAMS;s++)
+   {
+      x0[s]=_mm256_and_si256(x0[s],lo);
+      x1[s]=_mm256_and_si256(x1[s],lo);
+      x2[s]=_mm256_and_si256(x2[s],lo);
+      x3[s]=_mm256_and_si256(x3[s],lo);
+      a=_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(philoxToDouble(x0[s],5),s26),
+                                    philoxToDouble(x1[s],6)),s53);
+      b=_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(philoxToDouble(x2[s],5),s26),
+                                    philoxToDouble(x3[s],6)),s53);
+      ab0=_mm256_unpacklo_pd(a,b);
+      ab1=_mm256_unpackhi_pd(a,b);
+      _mm256_storeu_pd(r[s],_mm256_permute2f128_pd(ab0,ab1,0x20));
+      _mm256_storeu_pd(r[s]+4,_mm256_permute2f128_pd(ab0,ab1,0x31));
+   }
+}
+
+#endif
+
+
+static void philoxBatch(const uint32_t c[4],double r[2*PHILOX_LANES])
+{
+#if (PHILOX_AVX2==1)
+   if (__builtin_cpu_supports("avx2"))
+      philoxAvx2(c,r);
+   else
+      philoxGeneric(c,r);
+#else
+   philoxGeneric(c,r);
+#endif
+}
+
+
+/* The left[s] numbers of the slot s are the last ones of rbuf[s]. Moves them
+ * in front of the upper half of rbuf[s], to which the next batch of the
+ * stream is written. This is done for the ns slots slot[k] */
+static void refillSlots(int ns,const int slot[])
+{
+   int k,s,j,m;
+   double *b;
+#if (PHILOX_AVX2==1)
+   uint32_t *c[PHILOX_STREAMS];
+   double *r[PHILOX_STREAMS];
+#endif
+
+   for (k=0;k<ns;k++)
+   {
+      b=rbuf[slot[k]];
+      m=left[slot[k]];
+      for (j=0;j<m;j++)
+         b[2*PHILOX_LANES-m+j]=b[4*PHILOX_LANES-m+j];
+   }
+
+   k=0;
+#if (PHILOX_AVX2==1)
+   if (__builtin_cpu_supports("avx2"))
+   {
+      for (;k<=(ns-PHILOX_STREAMS);k+=PHILOX_STREAMS)
+      {
+         for (s=0;s<PHILOX_STREAMS;s++)
+         {
+            c[s]=ctr[slot[k+s]];
+            r[s]=rbuf[slot[k+s]]+2*PHILOX_LANES;
+         }
+         philoxAvx2Streams(c,r);
+      }
+   }
+#endif
+   for (;k<ns;k++)
+      philoxBatch(ctr[slot[k]],rbuf[slot[k]]+2*PHILOX_LANES);
+
+   for (k=0;k<ns;k++)
+   {
+      ctr[slot[k]][0]+=PHILOX_LANES;
+      left[slot[k]]+=2*PHILOX_LANES;
+   }
+}
+
+#endif
+
+
+void initRandomStreams(int seed)
+{
+#if (RNG_TYPE == 1)
+   key[0]=(uint32_t)(seed);
+   key[1]=0;
+#endif
+}
+
+
+void randomStreamSlot(int slot,int sweep,long int site,int dir)
+{
+#if (RNG_TYPE == 1)
+   uint32_t *c;
+
+   c=ctr[slot];
+   c[0]=0;
+   c[1]=(uint32_t)(sweep);
+   c[2]=(uint32_t)(site);
+   c[3]=(uint32_t)((uint64_t)(site)>>32)|((uint32_t)(dir)<<24);
+   left[slot]=0;
+#endif
+}
+
+
+void randomNumbersSlot(int slot,double r[],int n)
+{
+#if (RNG_TYPE == 1)
+   int m;
+   uint32_t *c;
+   double *b;
+
+   c=ctr[slot];
+   b=rbuf[slot]+2*PHILOX_LANES;
+   m=left[slot];
+   if (m>n)
+      m=n;
+   memcpy(r,b+2*PHILOX_LANES-left[slot],m*sizeof(double));
+   left[slot]-=m;
+   r+=m;
+   n-=m;
+
+   for (;n>=(2*PHILOX_LANES);n-=2*PHILOX_LANES,r+=2*PHILOX_LANES)
+   {
+      philoxBatch(c,r);
+      c[0]+=PHILOX_LANES;
+   }
+
+   if (n>0)
+   {
+      philoxBatch(c,b);
+      c[0]+=PHILOX_LANES;
+      memcpy(r,b,n*sizeof(double));
+      left[slot]=2*PHILOX_LANES-n;
+   }
+#else
+   ranlxd(r,n);
+#endif
+}
+
+
+void randomNumbersSlots(int ns,int slot[],double r[],int n)
+{
+   int k,j;
+#if (RNG_TYPE == 1)
+   int nr,need[RANDOM_SLOTS];
+   double *b;
+
+   error((ns>RANDOM_SLOTS)||(n>2*PHILOX_LANES),"randomNumbersSlots [philox.c]",
+         "Too many slots or random numbers!");
+
+   for (k=0,nr=0;k<ns;k++)
+   {
+      if (left[slot[k]]<n)
+         need[nr++]=slot[k];
+   }
+   if (nr>0)
+      refillSlots(nr,need);
+
+   for (k=0;k<ns;k++)
+   {
+      b=rbuf[slot[k]]+4*PHILOX_LANES-left[slot[k]];
+      for (j=0;j<n;j++)
+         r[j*ns+k]=b[j];
+      left[slot[k]]-=n;
+   }
+#else
+   double t;
+
+   for (k=0;k<ns;k++)
+   {
+      for (j=0;j<n;j++)
+      {
+         ranlxd(&t,1);
+         r[j*ns+k]=t;
+      }
+   }
+#endif
+}
+
+
+void philoxWords(const unsigned int k[2],const unsigned int c[4],unsigned int x[4])
+{
+#if (RNG_TYPE == 1)
+   uint32_t kk[2],cc[4],x0[PHILOX_LANES],x1[PHILOX_LANES],x2[PHILOX_LANES],x3[PHILOX_LANES];
+
+   kk[0]=k[0];
+   kk[1]=k[1];
+   cc[0]=c[0];
+   cc[1]=c[1];
+   cc[2]=c[2];
+   cc[3]=c[3];
+   philoxRounds(kk,cc,x0,x1,x2,x3);
+   x[0]=x0[0];
+   x[1]=x1[0];
+   x[2]=x2[0];
+   x[3]=x3[0];
+#else
+   error(1,"philoxWords [philox.c]","Philox is not used with RNG_TYPE 0!");
+#endif
+}
+
+
+int checkPhiloxAvx2(const unsigned int k[2],int n,unsigned int c[][4])
+{
+#if ((RNG_TYPE == 1)&&(PHILOX_AVX2==1))
+   int m,s,j,nd;
+   uint32_t ksave[2],cc[PHILOX_STREAMS][4],*cs[PHILOX_STREAMS];
+   double r0[2*PHILOX_LANES],r1[2*PHILOX_LANES];
+   double rs[PHILOX_STREAMS][2*PHILOX_LANES],*rp[PHILOX_STREAMS];
+
+   if (!__builtin_cpu_supports("avx2"))
+      return -1;
+
+   ksave[0]=key[0];
+   ksave[1]=key[1];
+   key[0]=k[0];
+   key[1]=k[1];
+
+   nd=0;
+   for (m=0;m<n;m+=PHILOX_STREAMS)
+   {
+      /* the last group is filled up with its first counter */
+      for (s=0;s<PHILOX_STREAMS;s++)
+      {
+         for (j=0;j<4;j++)
+            cc[s][j]=c[((m+s)<n)?(m+s):m][j];
+         cs[s]=cc[s];
+         rp[s]=rs[s];
+      }
+      philoxAvx2Streams(cs,rp);
+
+      for (s=0;(s<PHILOX_STREAMS)&&((m+s)<n);s++)
+      {
+         philoxGeneric(cc[s],r0);
+         philoxAvx2(cc[s],r1);
+         if ((memcmp(r0,r1,sizeof(r0))!=0)||(memcmp(r0,rs[s],sizeof(r0))!=0))
+            nd+=1;
+      }
+   }
+
+   key[0]=ksave[0];
+   key[1]=ksave[1];
+
+   return nd;
+#else
+   return -1;
+#endif
+}
+
+
+void randomStream(int sweep,long int site,int dir)
+{
+   randomStreamSlot(0,sweep,site,dir);
+}
+
+
+void randomNumbers(double r[],int n)
+{
+   randomNumbersSlot(0,r,n);
+}
@@ -12,7 +12,8 @@
 * Includes the routines to generate a random SU(3) matrix and bosons.
 * 
 * The routines included are similar to those used by Martin Luescher in
-* the DD-HMC code.
+* the DD-HMC code. The uniform random numbers are taken from the current
+* stream of the calling thread (see randomNumbers in philox.c).
 * 
 * Externally accessible functions:
 * 
@@ -24,7 +25,7 @@
 * 
 * void gauss(double *rd,int n)
 *      Returns n Gaussian distributed (e^{-r^2}) random numbers in the
-*      array rd.
+*      array rd (see getManyGaussianRandomNumbers in rng_gauss.c).
 * 
 * void su3RandomVector(su3vec *v)
 *      Returns a random su3vec v with non-zero norm, including Gaussian
@@ -41,7 +42,7 @@
 
 #include<float.h>
 #include"headers.h"
-#include"ranlxd.h"
+#include"modules.h"
 
 static int init_twopi=0;
 static double twopi;
@@ -62,24 +63,7 @@ int checkTwoPi(void)
 
 void gauss(double *rd,int n)
 {
-   int k;
-   double ud[2];
-   double x1,x2,rho,y1,y2;
-
-   for(k=0;k<n;)
-   {
-      ranlxd(ud,2);
-      x1=ud[0];
-      x2=ud[1];
-      rho=sqrt(-2.0*log(1.0-x1));
-      x2*=twopi;
-      y1=rho*sin(x2);
-      y2=rho*cos(x2);
-
-      rd[k++]=y1;
-      if(k<n)
-         rd[k++]=y2;
-   }
+   getManyGaussianRandomNumbers(rd,n,1.0);
 }
 
 
@@ -142,7 +126,7 @@ void su2RandomMatrix(su2mat *u)
 {
    double r[3],zw;
 
-   ranlxd(r,3);
+   randomNumbers(r,3);
    (*u).c0=1-2.*r[0];
    (*u).c1=1-2.*r[1];
    zw=sqrt(1.-(*u).c1*(*u).c1);
@@ -36,6 +36,10 @@
 *   void rlxd_reset(int state[])
 *     Resets the generator to the state defined by the array state[N]
 *
+* If compiled with OpenMP the state of the generator is private to each
+* thread, i.e. every thread has its own stream that has to be initialized
+* separately (see initThreadRandomNumbers in init.c)
+*
 *******************************************************************************/
 
 #define RANLXD_C
@@ -67,6 +71,10 @@ static union
    float num[96];
 } x __attribute__ ((aligned (16)));
 
+#ifdef _OPENMP
+#pragma omp threadprivate(init,pr,prm,ir,jr,is,is_old,next,one,one_bit,carry,x)
+#endif
+
 #define STEP(pi,pj) \
   __asm__ __volatile__ ("movaps %4, %%xmm4 \n\t" \
                         "movaps %%xmm2, %%xmm3 \n\t" \
@@ -381,6 +389,10 @@ static union
    int num[96];
 } x;
 
+#ifdef _OPENMP
+#pragma omp threadprivate(init,pr,prm,ir,jr,is,is_old,next,one_bit,carry,x)
+#endif
+
 #define STEP(pi,pj) \
       d=(*pj).c1.c1-(*pi).c1.c1-carry.c1; \
       (*pi).c2.c1+=(d<0); \
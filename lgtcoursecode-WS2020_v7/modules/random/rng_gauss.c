@@ -0,0 +1,125 @@
+
+/*******************************************************************************
+*
+* File rng_gauss.c
+*
+* Copyright (C) 2019 Francesca Cuteri
+* Copyright (C) 2016 Sebastian Schmalzbauer
+*
+* This software is distributed under the terms of the GNU General Public
+* License (GPL)
+*
+* Includes the batched generation of Gaussian random numbers with the
+* Box-Muller method.
+*
+* Externally accessible functions:
+*
+* void getManyGaussianRandomNumbers(double g[],int n,double sigma)
+*      Fills the first n elements of the array g with Gaussian random
+*      numbers with standard deviation sigma. The numbers are generated in
+*      pairs g[2j]=rho*sin(phi), g[2j+1]=rho*cos(phi), with
+*      rho=sigma*sqrt(-2*log(1-u1)) and phi=2*pi*u2, from the uniform
+*      numbers u1,u2 of the current stream of the calling thread (see
+*      randomNumbers in philox.c). For odd n the last cosine is dropped,
+*      i.e. 2*((n+1)/2) uniform numbers are used.
+*
+* The uniform numbers are fetched in blocks of GAUSS_BLOCK pairs. The
+* logarithm, sine and cosine are evaluated with the approximations of
+* fastmath.h, so that the compiler vectorises the loop over a block. On
+* x86-64 processors with AVX2 the loop runs on four pairs at a time. The
+* results agree with the ones of the C library to a few units in the last
+* place.
+*
+*******************************************************************************/
+
+#define RNG_GAUSS_C
+
+#include <math.h>
+#include "headers.h"
+#include "modules.h"
+#include "fastmath.h"
+
+#if (defined(__GNUC__)&&defined(__x86_64__))
+#define GAUSS_AVX2 1
+#else
+#define GAUSS_AVX2 0
+#endif
+
+#define GAUSS_BLOCK 64
+
+
+/* Computes the pairs g[2*j],g[2*j+1] from the uniform numbers u[2*j],u[2*j+1]
+ * for 0<=j<np */
+static inline __attribute__((always_inline)) void boxMullerLoop(const double u[],double g[],
+                                                                int np,double sigma)
+{
+   int j;
+   double rho,s,c;
+
+   for (j=0;j<np;j++)
+   {
+      rho=sigma*sqrt(-2.0*fast_log(1.0-u[2*j]));
+      fast_sincos2pi(u[2*j+1],&s,&c);
+      g[2*j]=rho*s;
+      g[2*j+1]=rho*c;
+   }
+}
+
+
+static void boxMullerGeneric(const double u[],double g[],int np,double sigma)
+{
+   boxMullerLoop(u,g,np,sigma);
+}
+
+
+#if (GAUSS_AVX2==1)
+
+/* The same loop compiled for AVX2, without FMA contractions, such that the
+ * results are identical */
+__attribute__((target("avx2")))
+static void boxMullerAvx2(const double u[],double g[],int np,double sigma)
+{
+   boxMullerLoop(u,g,np,sigma);
+}
+
+#endif
+
+
+static void boxMuller(const double u[],double g[],int np,double sigma)
+{
+#if (GAUSS_AVX2==1)
+   if (__builtin_cpu_supports("avx2"))
+      boxMullerAvx2(u,g,np,sigma);
+   else
+      boxMullerGeneric(u,g,np,sigma);
+#else
+   boxMullerGeneric(u,g,np,sigma);
+#endif
+}
+
+
+void getManyGaussianRandomNumbers(double g[],int n,double sigma)
+{
+   int np;
+   double u[2*GAUSS_BLOCK],t[2];
+
+   for (;n>=2*GAUSS_BLOCK;n-=2*GAUSS_BLOCK,g+=2*GAUSS_BLOCK)
+   {
+      randomNumbers(u,2*GAUSS_BLOCK);
+      boxMuller(u,g,GAUSS_BLOCK,sigma);
+   }
+
+   np=n/2;
+   if (np>0)
+   {
+      randomNumbers(u,2*np);
+      boxMuller(u,g,np,sigma);
+   }
+
+   if (n%2)
+   {
+      randomNumbers(u,2);
+      boxMuller(u,t,1,sigma);
+      g[n-1]=t[0];
+   }
+}
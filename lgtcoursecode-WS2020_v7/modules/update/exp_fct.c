@@ -43,6 +43,9 @@
 static double s1[4],s2[4],s3[4];
 static double r1;
 static complex z1,z2;
+#ifdef _OPENMP
+#pragma omp threadprivate(s1,s2,s3,r1,z1,z2)
+#endif
 
 
 
@@ -1,4 +1,3 @@
-
 /*******************************************************************************
  *
  * File heatbath.c
@@ -8,153 +7,526 @@
  * This software is distributed under the terms of the GNU General Public
  * License (GPL)
  *
- * Includes the routines to perform heatbath updates for pure gauge theory in SU(2).
+ * Includes the routines to perform heatbath updates for pure gauge theory in
+ * SU(2) and, with the Cabibbo-Marinari method, in SU(3).
  *
  * Externally accessible functions:
  *
- * void staples(int n,int dir,sun_mat *stap)
- *      Computes the staples for the link starting at point n in direction
- *      dir. The staples matrix is returned via the pointer stap.
+ * void staples(double *f,int n,int dir,sun_mat *stap)
+ *      Computes the staples of the gauge field f for the link starting at
+ *      point n in direction dir. The staples matrix is returned via the
+ *      pointer stap.
+ *
+ * void su2HeatbathBatch(int nb,int slot[],double alpha[],su2mat X[],int count[])
+ *      Generates nb SU(2) matrices X[l]=x0+i*x.sigma distributed with the
+ *      weight exp(alpha[l]*x0) with respect to the Haar measure. X[l] is
+ *      generated from the random numbers of the stream slot slot[l] (see
+ *      philox.c) and count[l] is set to the number of trials it took.
+ *
+ * double heatbathKernel(int nb,sun_mat u[],sun_mat stap[],double beta)
+ *      Replaces the nb links u[l] by heatbath updates with respect to the
+ *      staples stap[l] at the coupling beta, drawing the random numbers of
+ *      link l from the stream slot l. nb must not be larger than
+ *      RANDOM_SLOTS (see headers.h). Returns the summed acceptance, i.e.
+ *      the sum over the links of the number of SU(2) updates divided by the
+ *      number of trials. Links whose staples vanish in one of the SU(2)
+ *      subgroups are left unchanged and count as rejected.
+ *
+ * double heatbathUpdateLinks(double *f,int nb,int n[],int dir,double *dplaq)
+ *      Performs heatbath updates of the nb links U_dir(n[l]) of the gauge
+ *      field f with heatbathKernel. The links must not share any staple, e.g. they have
+ *      the same direction and parity. Returns the summed acceptance. The
+ *      summed change of Re tr(U_dir(n[l])*staples), i.e. of the summed real
+ *      traces of the plaquettes, is added to *dplaq.
+ *
+ * double localHeatbathUpdate(double *f,int n,int dir,int m,double *dplaq)
+ *        Performs m local Heatbath update steps for the link U_dir(n) of
+ *        the gauge field f,
+ *        drawing from the current stream of the calling thread (slot 0).
+ *        On return it hands back the fraction of successful updates. The
+ *        change of the summed plaquette is added to *dplaq.
  *
- * double localHeatbathUpdate(int n,int dir,int m)
- *        Performs m local Heatbath update steps for the link U_dir(n).
- *        On return it hands back the fraction of successful updates.
- *        For now only works for SUN=2.
+ * The SU(2) matrices are generated with the method of Kennedy and Pendleton
+ * for alpha>=HB_ALPHA_KP and with the one of Creutz otherwise, where it has
+ * the better acceptance rate. Every trial draws 4 random numbers of the
+ * stream of its link (Creutz uses the first and the last of them), an
+ * accepted x0 2 further numbers for the direction of x. The trials of all
+ * links of a batch are done together, the links whose trial is rejected
+ * are collected and tried again. The logarithms, the cosine and the square
+ * roots are evaluated with fastmath.h in loops over the batch, which are
+ * vectorised by the compiler (with AVX2 on x86-64 processors that support
+ * it). The random numbers of all links are drawn with one call of
+ * randomNumbersSlots (see philox.c). The generated matrices do not depend
+ * on the other links of the batch.
+ *
+ * For SU(3) heatbathKernel copies the links and staples of the batch into
+ * arrays with the link index innermost (struct su3batch), such that the
+ * loops over the batch run on whole vector registers. For each of the
+ * subgroups only the four elements of link*stap in its rows and columns
+ * are computed and the SU(2) matrix is applied to the two rows of the link
+ * it acts on. The operations are the same as those of su3_mat_mul with
+ * extr_sub1 etc. and create_su3_sub1 etc., without the terms with the
+ * zeros and ones of the embedded matrix, so the links are the same.
  *
  *******************************************************************************/
 
-#define HEATHBATH_C
+#define HEATBATH_C
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
-#include "ranlxd.h"
 #include "headers.h"
 #include "modules.h"
+#include "fastmath.h"
+
+#if (defined(__GNUC__) && defined(__x86_64__))
+#define HB_AVX2 1
+#else
+#define HB_AVX2 0
+#endif
+
+/* the acceptance rates of the two methods cross near alpha=1.7 */
+#define HB_ALPHA_KP 1.7
+
+/* work space of su2HeatbathBatch, r holds the uniform numbers of the links
+ * of the batch (see randomNumbersSlots in philox.c) */
+typedef struct
+{
+    double r[4 * RANDOM_SLOTS];
+    double alpha[RANDOM_SLOTS], w[RANDOM_SLOTS], kp[RANDOM_SLOTS];
+    double d[RANDOM_SLOTS], delta[RANDOM_SLOTS];
+    double x[4][RANDOM_SLOTS];
+    uint64_t rej[RANDOM_SLOTS];
+} su2batch;
+
+/* work space of heatbathKernel, the links and staples of the batch in SoA
+ * form, link[2*(3*i+j)][l]=Re u[l].cij and link[2*(3*i+j)+1][l]=Im u[l].cij
+ * (counting from 0), and the SU(2) parts a of the current subgroup */
+typedef struct
+{
+    double link[18][RANDOM_SLOTS], stap[18][RANDOM_SLOTS];
+    double a[4][RANDOM_SLOTS], sdet[RANDOM_SLOTS], alpha[RANDOM_SLOTS];
+    su2batch s;
+} su3batch;
+
+/* Trials of na links with the uniform numbers u0,..,u3=r[k],..,r[3*na+k].
+ * kp[k]=1 selects the method of Kennedy and Pendleton, kp[k]=0 the one of
+ * Creutz with w[k]=1-exp(-2*alpha[k]). Sets d[k]=1-x0 and rej[k]=1 if the
+ * trial is rejected, 0 otherwise */
+static inline __attribute__((always_inline)) void trialLoop(int na, su2batch *b)
+{
+    int k;
+    double s, c, d, bound, u3;
+
+    for (k = 0; k < na; k++)
+    {
+        fast_sincos2pi(b->r[na + k], &s, &c);
+        d = -(fast_log(1.0 - b->r[k] * b->w[k]) + c * c * fast_log(1.0 - b->r[2 * na + k] * b->kp[k])) /
+            b->alpha[k];
+        bound = b->kp[k] * (1.0 - 0.5 * d) + (1.0 - b->kp[k]) * d * (2.0 - d);
+        u3 = b->r[3 * na + k];
+        b->d[k] = d;
+        b->rej[k] = fm_bits(bound - u3 * u3) >> 63;
+    }
+}
+
+/* x=(1-delta,sqrt(1-(1-delta)^2)*n) with the unit vector n given by the
+ * uniform numbers v0,v1=r[l],r[nb+l] */
+static inline __attribute__((always_inline)) void angleLoop(int nb, su2batch *b)
+{
+    int l;
+    double ct, st, s, c, len;
+
+    for (l = 0; l < nb; l++)
+    {
+        ct = 2.0 * b->r[l] - 1.0;
+        st = sqrt(1.0 - ct * ct);
+        fast_sincos2pi(b->r[nb + l], &s, &c);
+        len = sqrt(b->delta[l] * (2.0 - b->delta[l]));
+        b->x[0][l] = 1.0 - b->delta[l];
+        b->x[1][l] = len * st * c;
+        b->x[2][l] = len * st * s;
+        b->x[3][l] = len * ct;
+    }
+}
+
+#if (SUN == 3)
+/* element (r,c) of the product of the SU(3) matrices l and s of the lane k of
+ * a batch in SoA form. The terms are summed in the order of su3_mat_mul */
+#define soa_mul_re(l, s, r, c, k)                                                                  \
+    ((l)[6 * (r)][k] * (s)[2 * (c)][k] - (l)[6 * (r) + 1][k] * (s)[2 * (c) + 1][k] +               \
+     (l)[6 * (r) + 2][k] * (s)[6 + 2 * (c)][k] - (l)[6 * (r) + 3][k] * (s)[7 + 2 * (c)][k] +       \
+     (l)[6 * (r) + 4][k] * (s)[12 + 2 * (c)][k] - (l)[6 * (r) + 5][k] * (s)[13 + 2 * (c)][k])
+
+#define soa_mul_im(l, s, r, c, k)                                                                  \
+    ((l)[6 * (r)][k] * (s)[2 * (c) + 1][k] + (l)[6 * (r) + 1][k] * (s)[2 * (c)][k] +               \
+     (l)[6 * (r) + 2][k] * (s)[7 + 2 * (c)][k] + (l)[6 * (r) + 3][k] * (s)[6 + 2 * (c)][k] +       \
+     (l)[6 * (r) + 4][k] * (s)[13 + 2 * (c)][k] + (l)[6 * (r) + 5][k] * (s)[12 + 2 * (c)][k])
+
+/* rows and columns i<j of the SU(2) subgroups 1,2,3 (see extr_sub1 etc.) */
+static const int subRows[3][2] = {{0, 1}, {1, 2}, {0, 2}};
+
+/* a[.][k]=SU(2) part in the rows and columns i,j of link[k]*stap[k], of which
+ * only these four elements are computed, sdet[k]=sqrt(det(a)) and
+ * alpha[k]=2*beta*sdet[k]/3 */
+static inline __attribute__((always_inline)) void subgroupLoop(int nb, int i, int j, double beta,
+                                                               su3batch *b)
+{
+    int k;
+    double d;
+
+    for (k = 0; k < nb; k++)
+    {
+        b->a[0][k] = (soa_mul_re(b->link, b->stap, i, i, k) + soa_mul_re(b->link, b->stap, j, j, k)) / 2.;
+        b->a[1][k] = (soa_mul_im(b->link, b->stap, i, j, k) + soa_mul_im(b->link, b->stap, j, i, k)) / 2.;
+        b->a[2][k] = (soa_mul_re(b->link, b->stap, i, j, k) - soa_mul_re(b->link, b->stap, j, i, k)) / 2.;
+        b->a[3][k] = (soa_mul_im(b->link, b->stap, i, i, k) - soa_mul_im(b->link, b->stap, j, j, k)) / 2.;
+
+        d = b->a[0][k] * b->a[0][k];
+        d += b->a[1][k] * b->a[1][k];
+        d += b->a[2][k] * b->a[2][k];
+        d += b->a[3][k] * b->a[3][k];
+        b->sdet[k] = sqrt(fabs(d));
+        b->alpha[k] = b->sdet[k] * beta * 2.0 / 3.0;
+    }
+}
+
+/* Multiplies the rows i,j of link[k] from the left with the SU(2) matrix
+ * u=s.x[.][k]*(a[.][k]/sdet[k])^dag, i.e. with the SU(3) matrix that
+ * create_su3_sub1 etc. build from u. The zeros and ones of that matrix are
+ * left out, which does not change the result */
+static inline __attribute__((always_inline)) void rotateLoop(int nb, int i, int j, su3batch *b)
+{
+    int k, c;
+    double v0, v1, v2, v3, u0, u1, u2, u3, m2, m3, lir, lii, ljr, lji;
+
+    for (k = 0; k < nb; k++)
+    {
+        v0 = b->a[0][k] / b->sdet[k];
+        v1 = b->a[1][k] / b->sdet[k];
+        v2 = b->a[2][k] / b->sdet[k];
+        v3 = b->a[3][k] / b->sdet[k];
+
+        u0 = b->s.x[0][k] * v0 + b->s.x[1][k] * v1 + b->s.x[2][k] * v2 + b->s.x[3][k] * v3;
+        u1 = -b->s.x[0][k] * v1 + b->s.x[1][k] * v0 + b->s.x[2][k] * v3 - b->s.x[3][k] * v2;
+        u2 = -b->s.x[0][k] * v2 - b->s.x[1][k] * v3 + b->s.x[2][k] * v0 + b->s.x[3][k] * v1;
+        u3 = -b->s.x[0][k] * v3 + b->s.x[1][k] * v2 - b->s.x[2][k] * v1 + b->s.x[3][k] * v0;
+        m2 = -u2;
+        m3 = -u3;
+
+        for (c = 0; c < 3; c++)
+        {
+            lir = b->link[6 * i + 2 * c][k];
+            lii = b->link[6 * i + 2 * c + 1][k];
+            ljr = b->link[6 * j + 2 * c][k];
+            lji = b->link[6 * j + 2 * c + 1][k];
+
+            b->link[6 * i + 2 * c][k] = u0 * lir - u3 * lii + u2 * ljr - u1 * lji;
+            b->link[6 * i + 2 * c + 1][k] = u0 * lii + u3 * lir + u2 * lji + u1 * ljr;
+            b->link[6 * j + 2 * c][k] = m2 * lir - u1 * lii + u0 * ljr - m3 * lji;
+            b->link[6 * j + 2 * c + 1][k] = m2 * lii + u1 * lir + u0 * lji + m3 * ljr;
+        }
+    }
+}
+#endif
+
+static void trialGeneric(int na, su2batch *b)
+{
+    trialLoop(na, b);
+}
+
+static void angleGeneric(int nb, su2batch *b)
+{
+    angleLoop(nb, b);
+}
+
+#if (SUN == 3)
+static void subgroupGeneric(int nb, int i, int j, double beta, su3batch *b)
+{
+    subgroupLoop(nb, i, j, beta, b);
+}
+
+static void rotateGeneric(int nb, int i, int j, su3batch *b)
+{
+    rotateLoop(nb, i, j, b);
+}
+#endif
+
+#if (HB_AVX2 == 1)
+
+/* The same loops compiled for AVX2, without FMA contractions, such that the
+ * results are identical */
+__attribute__((target("avx2"))) static void trialAvx2(int na, su2batch *b)
+{
+    trialLoop(na, b);
+}
+
+__attribute__((target("avx2"))) static void angleAvx2(int nb, su2batch *b)
+{
+    angleLoop(nb, b);
+}
 
-double generateSU2InHeatbath(su2mat *X, double alpha)
+#if (SUN == 3)
+__attribute__((target("avx2"))) static void subgroupAvx2(int nb, int i, int j, double beta, su3batch *b)
 {
-    int count = 0;
-    double ud[4], lambda_sqr, angles[2], length, x[4];
+    subgroupLoop(nb, i, j, beta, b);
+}
+
+__attribute__((target("avx2"))) static void rotateAvx2(int nb, int i, int j, su3batch *b)
+{
+    rotateLoop(nb, i, j, b);
+}
+#endif
+
+#endif
+
+/* Generates the SU(2) matrices of su2HeatbathBatch in b->x[.][l] */
+static void su2Heatbath(int nb, int slot[], double alpha[], int count[], su2batch *b)
+{
+    int l, k, m, na, avx2, act[RANDOM_SLOTS], sl[RANDOM_SLOTS];
+    double w[RANDOM_SLOTS], kp[RANDOM_SLOTS];
+
+#if (HB_AVX2 == 1)
+    avx2 = __builtin_cpu_supports("avx2");
+#else
+    avx2 = 0;
+#endif
+
+    for (l = 0; l < nb; l++)
+    {
+        count[l] = 0;
+        if (alpha[l] >= HB_ALPHA_KP)
+        {
+            kp[l] = 1.0;
+            w[l] = 1.0;
+        }
+        else
+        {
+            kp[l] = 0.0;
+            w[l] = -expm1(-2.0 * alpha[l]);
+        }
+        act[l] = l;
+        sl[l] = slot[l];
+        b->alpha[l] = alpha[l];
+        b->w[l] = w[l];
+        b->kp[l] = kp[l];
+    }
 
-    do
+    /* the links in act[0..na-1] still need an accepted trial, their
+     * parameters are in sl[k] and b->alpha[k] etc. */
+    na = nb;
+    while (na > 0)
     {
-        ranlxd(ud, 4);
-        lambda_sqr = -1.0 / alpha * (log(1. - ud[1]) + pow(cos(2 * M_PI * (1. - ud[2])), 2) * log(1. - ud[3]));
-        count++;
-    } while (pow(ud[3], 2) > 1 - 0.5 * pow(lambda_sqr, 2));
-
-    ranlxd(angles, 2);
-    angles[0] *= 2.;
-    angles[0] -= 1.;
-    angles[0] = acos(angles[1]);
-    angles[1] *= 2. * PI;
-
-    x[0] = 1 - lambda_sqr;
-    length = sqrt(1 - pow(x[0], 2));
-    x[1] = length * sin(angles[0]) * cos(angles[1]);
-    x[2] = length * sin(angles[0]) * sin(angles[1]);
-    x[3] = length * cos(angles[0]);
-
-    mk_dble_array_su2(x, *X);
-
-#if DEBUG == 1
-    double det_1, det_2;
-    su2mat X_dag, res;
-    su2_dag(X_dag, X);
-    su2_mat_mul(res, X_dag, X);
-    su2_det(det_2, res);
-    su2_det(det_1, X);
-    printf("%3.20f   %3.20f\n", det_1, det_2);
+        randomNumbersSlots(na, sl, b->r, 4);
+
+#if (HB_AVX2 == 1)
+        if (avx2)
+            trialAvx2(na, b);
+        else
+#endif
+            trialGeneric(na, b);
+
+        m = na;
+        for (k = 0, na = 0; k < m; k++)
+        {
+            l = act[k];
+            count[l]++;
+            if (b->rej[k])
+            {
+                act[na] = l;
+                sl[na] = slot[l];
+                b->alpha[na] = alpha[l];
+                b->w[na] = w[l];
+                b->kp[na] = kp[l];
+                na++;
+            }
+            else
+                b->delta[l] = b->d[k];
+        }
+    }
+
+    randomNumbersSlots(nb, slot, b->r, 2);
+
+#if (HB_AVX2 == 1)
+    if (avx2)
+        angleAvx2(nb, b);
+    else
 #endif
-    return count;
+        angleGeneric(nb, b);
+}
+
+void su2HeatbathBatch(int nb, int slot[], double alpha[], su2mat X[], int count[])
+{
+    int l;
+    su2batch b;
+
+    error(nb > RANDOM_SLOTS, "su2HeatbathBatch [heatbath.c]", "Batch larger than RANDOM_SLOTS!");
+
+    su2Heatbath(nb, slot, alpha, count, &b);
+
+    for (l = 0; l < nb; l++)
+    {
+        X[l].c0 = b.x[0][l];
+        X[l].c1 = b.x[1][l];
+        X[l].c2 = b.x[2][l];
+        X[l].c3 = b.x[3][l];
+    }
 }
 
-double localHeatbathUpdate(int n, int dir, int m)
+double heatbathKernel(int nb, sun_mat u[], sun_mat stap[], double beta)
 {
+    int l, act[RANDOM_SLOTS], count[RANDOM_SLOTS];
+    double acc;
 
-    int count = 0;
-    double sqrt_det, alpha;
+    error(nb > RANDOM_SLOTS, "heatbathKernel [heatbath.c]", "Batch larger than RANDOM_SLOTS!");
 
 #if (SUN == 2)
-    su2mat A, X, U;
 
-    staples(n, dir, &A);
-    su2_det_sqrt(sqrt_det, A);
+    int k, na;
+    double sqrt_det, alpha[RANDOM_SLOTS];
+    su2mat A[RANDOM_SLOTS], X[RANDOM_SLOTS], U;
 
-    if (sqrt_det <= __DBL_EPSILON__)
+    /* the links in act[0..na-1] have non-vanishing staples */
+    for (l = 0, na = 0; l < nb; l++)
     {
-        /*su2RandomMatrix(pu[n][dir]);*/
-        return 0.0;
+        A[na] = stap[l];
+        su2_det_sqrt(sqrt_det, A[na]);
+        if (sqrt_det <= __DBL_EPSILON__)
+            continue;
+        su2_dble_div(A[na], sqrt_det);
+        alpha[na] = sqrt_det * beta;
+        act[na++] = l;
     }
 
-    su2_dble_div(A, sqrt_det);
+    su2HeatbathBatch(na, act, alpha, X, count);
 
-    alpha = sqrt_det * runParams.beta;
+    acc = 0.0;
+    for (k = 0; k < na; k++)
+    {
+        su2_mat_mul_dag(U, X[k], A[k]); /*U = X*V^dag*/
+        u[act[k]] = U;
+        acc += 1.0 / count[k];
+    }
 
-    count += generateSU2InHeatbath(&X, alpha);
-    su2_mat_mul_dag(U, X, A); /*U = X*V^dag*/
-    *pu[n][dir] = U;
-    return 1.0 / count;
+    return acc;
 
 #elif (SUN == 3)
 
-    su3mat heatbath_su3, old_link, staple_sum, Temp_1, Temp_2;
-    su2mat heatbath_su2, generated, new_link_su2;
+    int c, i, j, isub, avx2, live[RANDOM_SLOTS], ntot[RANDOM_SLOTS];
+    su3batch b;
 
-    staples(n, dir, &staple_sum);
-    old_link = *pu[n][dir];
+#if (HB_AVX2 == 1)
+    avx2 = __builtin_cpu_supports("avx2");
+#else
+    avx2 = 0;
+#endif
 
-    for (int i = 1; i <= 3; i++)
+    for (l = 0; l < nb; l++)
     {
-        su3_mat_mul(heatbath_su3, old_link, staple_sum);
-        switch (i)
+        for (c = 0; c < 18; c++)
         {
-        case 1:
-            extr_sub1(heatbath_su2, heatbath_su3);
-            break;
-        case 2:
-            extr_sub2(heatbath_su2, heatbath_su3);
-            break;
-        case 3:
-            extr_sub3(heatbath_su2, heatbath_su3);
-            break;
+            b.link[c][l] = ((double *)(u + l))[c];
+            b.stap[c][l] = ((double *)(stap + l))[c];
         }
-        su2_det_sqrt(sqrt_det, heatbath_su2);
+        act[l] = l;
+        live[l] = 1;
+        ntot[l] = 0;
+    }
 
-        if (sqrt_det <= __DBL_EPSILON__)
+    for (isub = 0; isub < 3; isub++)
+    {
+        i = subRows[isub][0];
+        j = subRows[isub][1];
+
+#if (HB_AVX2 == 1)
+        if (avx2)
+            subgroupAvx2(nb, i, j, beta, &b);
+        else
+#endif
+            subgroupGeneric(nb, i, j, beta, &b);
+
+        /* links with vanishing staples in one of the subgroups are not
+         * updated any more. Their SU(2) matrices are still generated, with
+         * alpha=1, but they are rotated with the unit matrix */
+        for (l = 0; l < nb; l++)
         {
-            /*su3RandomMatrix(pu[n][dir]);*/
-            return 0.0;
+            if (b.sdet[l] <= __DBL_EPSILON__)
+                live[l] = 0;
+            if (live[l] == 0)
+                b.alpha[l] = 1.0;
         }
-        su2_dble_div(heatbath_su2, sqrt_det);
-
-        alpha = sqrt_det * runParams.beta * 2.0 / 3.0;
 
-        count += generateSU2InHeatbath(&generated, alpha);
-        su2_mat_mul_dag(new_link_su2, generated, heatbath_su2);
+        su2Heatbath(nb, act, b.alpha, count, &b.s);
 
-        switch (i)
+        for (l = 0; l < nb; l++)
         {
-        case 1:
-            create_su3_sub1(Temp_1, new_link_su2);
-            break;
-        case 2:
-            create_su3_sub2(Temp_1, new_link_su2);
-            break;
-        case 3:
-            create_su3_sub3(Temp_1, new_link_su2);
-            break;
+            if (live[l])
+                ntot[l] += count[l];
+            else
+            {
+                b.s.x[0][l] = b.a[0][l] = b.sdet[l] = 1.0;
+                b.s.x[1][l] = b.a[1][l] = 0.0;
+                b.s.x[2][l] = b.a[2][l] = 0.0;
+                b.s.x[3][l] = b.a[3][l] = 0.0;
+            }
         }
 
-        su3_mat_mul(Temp_2, Temp_1, heatbath_su3);
-        heatbath_su3 = Temp_2;
-        su3_mat_mul(Temp_2, Temp_1, old_link);
-        old_link = Temp_2;
+#if (HB_AVX2 == 1)
+        if (avx2)
+            rotateAvx2(nb, i, j, &b);
+        else
+#endif
+            rotateGeneric(nb, i, j, &b);
     }
 
-    *pu[n][dir] = old_link;
+    acc = 0.0;
+    for (l = 0; l < nb; l++)
+    {
+        if (live[l])
+        {
+            for (c = 0; c < 18; c++)
+                ((double *)(u + l))[c] = b.link[c][l];
+            acc += 3.0 / ntot[l];
+        }
+    }
 
-    return 3.0 / count;
+    return acc;
 #endif
-}
\ No newline at end of file
+}
+
+double heatbathUpdateLinks(double *f, int nb, int n[], int dir, double *dplaq)
+{
+    int l;
+    double acc, tr, tr_old[RANDOM_SLOTS];
+    sun_mat u[RANDOM_SLOTS], stap[RANDOM_SLOTS];
+
+    for (l = 0; l < nb; l++)
+    {
+        staples(f, n[l], dir, &stap[l]);
+        gf_get(u[l], f, n[l], dir);
+        sun_trace_mul(tr_old[l], u[l], stap[l]);
+    }
+
+    acc = heatbathKernel(nb, u, stap, runParams.beta);
+
+    for (l = 0; l < nb; l++)
+    {
+        gf_set(f, n[l], dir, u[l]);
+        sun_trace_mul(tr, u[l], stap[l]);
+        *dplaq += tr - tr_old[l];
+    }
+
+    return acc;
+}
+
+double localHeatbathUpdate(double *f, int n, int dir, int m, double *dplaq)
+{
+    int k;
+    double acc;
+
+    acc = 0.0;
+    for (k = 0; k < m; k++)
+        acc += heatbathUpdateLinks(f, 1, &n, dir, dplaq);
+
+    return acc / m;
+}
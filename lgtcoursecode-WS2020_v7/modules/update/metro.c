@@ -12,13 +12,17 @@
  *
  * Externally accessible functions:
  *
- * void staples(int n,int dir,sun_mat *stap)
- *      Computes the staples for the link starting at point n in direction
- *      dir. The staples matrix is returned via the pointer stap.
+ * void staples(double *f,int n,int dir,sun_mat *stap)
+ *      Computes the staples of the gauge field f for the link starting at
+ *      point n in direction dir. The staples matrix is returned via the
+ *      pointer stap.
  *
- * double localMetropolisUpdate(int n,int dir,int m)
- *        Performs m local Metropolis update steps for the link U_dir(n).
- *        On return it hands back the fraction of successful updates.
+ * double localMetropolisUpdate(double *f,int n,int dir,int m,double *dplaq)
+ *        Performs m local Metropolis update steps for the link U_dir(n) of
+ *        the gauge field f.
+ *        On return it hands back the fraction of successful updates. The
+ *        change of Re tr(U_dir(n)*staples), i.e. of the summed real traces
+ *        of the plaquettes, is added to *dplaq.
  *
  *******************************************************************************/
 
@@ -27,14 +31,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
-#include "ranlxd.h"
 #include "headers.h"
 #include "modules.h"
 
-void staples(int n, int dir, sun_mat *stap)
+void staples(double *f, int n, int dir, sun_mat *stap)
 {
    int kk, n1, n2;
-   sun_mat un[4];
+   sun_mat un[4], u1, u2, u3;
 
    sun_zero(un[3]);
 
@@ -45,16 +48,22 @@ void staples(int n, int dir, sun_mat *stap)
          n1 = neib[n][dir];
          n2 = neib[n][kk];
 
-         sun_mul_dag(un[1], *pu[n1][kk], *pu[n2][dir]);
-         sun_mul_dag(un[0], un[1], *pu[n][kk]);
+         gf_get(u1, f, n1, kk);
+         gf_get(u2, f, n2, dir);
+         gf_get(u3, f, n, kk);
+         sun_mul_dag(un[1], u1, u2);
+         sun_mul_dag(un[0], un[1], u3);
          sun_add(un[2], un[3], un[0]);
 
          n2 = neib[n][kk + DIM];
          n1 = neib[n2][dir];
 
-         sun_dag(un[0], *pu[n1][kk]);
-         sun_mul_dag(un[1], un[0], *pu[n2][dir]);
-         sun_mul(un[0], un[1], *pu[n2][kk]);
+         gf_get(u1, f, n1, kk);
+         gf_get(u2, f, n2, dir);
+         gf_get(u3, f, n2, kk);
+         sun_dag(un[0], u1);
+         sun_mul_dag(un[1], un[0], u2);
+         sun_mul(un[0], un[1], u3);
          sun_add(un[3], un[2], un[0]);
       }
    }
@@ -68,42 +77,47 @@ static void proposeNewLink(sun_mat *u)
    double r[ALGVOL], *a;
    sun_alg X;
 
-   ranlxd(r, ALGVOL);
+   randomNumbers(r, ALGVOL);
    a = (double *)(&X);
    for (i = 0; i < ALGVOL; i++, a++)
       *a = (1. - 2. * r[i]);
    expx(runParams.eps, &X, u);
 }
 
-double localMetropolisUpdate(int n, int dir, int m)
+double localMetropolisUpdate(double *f, int n, int dir, int m, double *dplaq)
 {
    int im, iac;
-   double lpl, lpl_old, dact, r[1];
-   sun_mat stap, upr, zw;
+   double lpl, lpl_old, lpl_start, dact, r[1];
+   sun_mat stap, upr, uold, zw;
 
-   staples(n, dir, &stap);
+   staples(f, n, dir, &stap);
 
-   upr = *pu[n][dir];
+   gf_get(uold, f, n, dir);
+   upr = uold;
+
+   sun_mul(zw, upr, stap);
+   sun_trace(lpl_old, zw);
+   lpl_start = lpl_old;
 
    for (im = 0, iac = 0; im < m; im++)
    {
-      sun_mul(zw, upr, stap);
-      sun_trace(lpl_old, zw);
-
       proposeNewLink(&upr);
       sun_mul(zw, upr, stap);
       sun_trace(lpl, zw);
       dact = exp(runParams.beta * (lpl - lpl_old) / (double)(SUN));
 
-      ranlxd(r, 1);
+      randomNumbers(r, 1);
       if (r[0] <= dact)
       {
-         *pu[n][dir] = upr;
+         uold = upr;
+         lpl_old = lpl;
          iac++;
       }
       else
-         upr = *pu[n][dir];
+         upr = uold;
    }
+   gf_set(f, n, dir, uold);
+   *dplaq += lpl_old - lpl_start;
 
    return (double)(iac) / m;
 }
@@ -0,0 +1,189 @@
+
+/*******************************************************************************
+ *
+ * File mf_colour.c
+ *
+ * This software is distributed under the terms of the GNU General Public
+ * License (GPL)
+ *
+ * Includes the master-field sweep in which sublattices without common outer
+ * layers are updated at the same time by the OpenMP threads.
+ *
+ * Externally accessible functions:
+ *
+ * void initMasterFieldColouring(void)
+ *      Colours the sublattice grid with 2^DIM colours, given by the parities
+ *      of the sublattice coordinates, and allocates one sublattice gauge
+ *      field for every OpenMP thread but the master thread, which uses pu.
+ *      The number of sublattices must be even or 1 in every direction.
+ *
+ * void releaseMasterFieldColouring(void)
+ *      Frees the fields allocated by initMasterFieldColouring. The standard
+ *      gauge field is left allocated.
+ *
+ * double masterFieldSweepColoured(char *cnfg_file, int iup, int nup)
+ *      Performs gaugefieldUpdateSublattice(f,n_sl,iup,nup,SIM_TYPE,SWEEP_TYPE)
+ *      on all VOL_SL sublattices of the master field stored in cnfg_file,
+ *      where f is the field of the thread, and returns the
+ *      plaquette of the master field after the sweep (see trackedPlaquette
+ *      in update.c). The colours are processed one after the other. The
+ *      sublattices of a colour are distributed statically over the threads
+ *      and every thread reads a sublattice into its own field, updates it
+ *      and writes it back. Sublattices of the same colour are separated by
+ *      at least one sublattice, so none of them has outer layers in the core
+ *      of another one, and all of them are written before the next colour is
+ *      read. The neighbour arrays are the same for all sublattices and are
+ *      shared by the threads. The checkerboard sweeps of a sublattice run
+ *      on the thread that owns it. With RNG_TYPE 1 (see philox.c) the
+ *      configurations depend only on the seed, with RNG_TYPE 0 every thread
+ *      uses its own ranlxd generator (see initThreadRandomNumbers in init.c)
+ *      and they also depend on the number of threads.
+ *
+ *******************************************************************************/
+
+#define MF_COLOUR_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "headers.h"
+#include "modules.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if (MASTER_FIELD == 1)
+
+#define NCOLOUR (1 << DIM)
+
+static int init = 0, nthreads = 1;
+static int order[VOL_SL], start[NCOLOUR + 1];
+static double **buf = NULL;
+
+void initMasterFieldColouring(void)
+{
+    int n_sl, m, dir, b, col, t;
+    int latticeExtent[DIM], latticeExtent_mf[DIM], next[NCOLOUR];
+    int *colour;
+
+    checkpoint("initMasterFieldColouring -- in");
+
+    error(init != 0, "initMasterFieldColouring [mf_colour.c]",
+          "Colouring already initialised!");
+    error(pu == NULL, "initMasterFieldColouring [mf_colour.c]",
+          "Gauge field is not allocated!");
+
+    masterFieldExtents(latticeExtent, latticeExtent_mf);
+    for (dir = 0; dir < DIM; dir++)
+    {
+        b = latticeExtent_mf[dir] / latticeExtent[dir];
+        error((b > 1) && ((b % 2) != 0), "initMasterFieldColouring [mf_colour.c]",
+              "The number of sublattices must be even or 1 in every direction!");
+    }
+
+    colour = malloc(VOL_SL * sizeof(int));
+    error(colour == NULL, "initMasterFieldColouring [mf_colour.c]",
+          "Unable to allocate buffers!");
+
+    /* the last direction runs fastest as in sl */
+    for (col = 0; col <= NCOLOUR; col++)
+        start[col] = 0;
+    for (n_sl = 0; n_sl < VOL_SL; n_sl++)
+    {
+        m = n_sl;
+        col = 0;
+        for (dir = DIM - 1; dir >= 0; dir--)
+        {
+            b = latticeExtent_mf[dir] / latticeExtent[dir];
+            col += ((m % b) % 2) << dir;
+            m /= b;
+        }
+        colour[n_sl] = col;
+        start[col + 1]++;
+    }
+    for (col = 0; col < NCOLOUR; col++)
+    {
+        start[col + 1] += start[col];
+        next[col] = start[col];
+    }
+    for (n_sl = 0; n_sl < VOL_SL; n_sl++)
+        order[next[colour[n_sl]]++] = n_sl;
+    free(colour);
+
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    buf = malloc(nthreads * sizeof(double *));
+    error(buf == NULL, "initMasterFieldColouring [mf_colour.c]",
+          "Unable to allocate buffers!");
+    buf[0] = pu;
+    for (t = 1; t < nthreads; t++)
+        allocateGaugeField(&buf[t]);
+    init = 1;
+
+    checkpoint("initMasterFieldColouring -- out");
+}
+
+void releaseMasterFieldColouring(void)
+{
+    int t;
+
+    checkpoint("releaseMasterFieldColouring");
+
+    error(init == 0, "releaseMasterFieldColouring [mf_colour.c]",
+          "Colouring not initialised!");
+
+    for (t = 1; t < nthreads; t++)
+        deallocateGaugeField(&buf[t]);
+    free(buf);
+    buf = NULL;
+    init = 0;
+}
+
+double masterFieldSweepColoured(char *cnfg_file, int iup, int nup)
+{
+    int col;
+    double t1;
+
+    checkpoint("masterFieldSweepColoured -- in");
+
+    error(init == 0, "masterFieldSweepColoured [mf_colour.c]",
+          "Colouring not initialised!");
+    error(buf[0] != pu, "masterFieldSweepColoured [mf_colour.c]",
+          "Gauge field pu has changed!");
+    t1 = getTime();
+
+    for (col = 0; col < NCOLOUR; col++)
+    {
+        if (start[col] == start[col + 1])
+            continue;
+
+#pragma omp parallel num_threads(nthreads)
+        {
+            int k, tid;
+            double *f;
+
+#ifdef _OPENMP
+            tid = omp_get_thread_num();
+#else
+            tid = 0;
+#endif
+            f = buf[tid];
+
+#pragma omp for schedule(static)
+            for (k = start[col]; k < start[col + 1]; k++)
+            {
+                readConfigSublattice(cnfg_file, f, order[k]);
+                gaugefieldUpdateSublattice(f, order[k], iup, nup, SIM_TYPE, SWEEP_TYPE);
+                writeConfigSublattice(cnfg_file, f, order[k]);
+            }
+        }
+    }
+
+    checkpoint("masterFieldSweepColoured -- out");
+    logging("\nColoured master-field sweep took %.3e sec on %d threads\n",
+            getTime() - t1, nthreads);
+
+    return trackedPlaquette();
+}
+
+#endif
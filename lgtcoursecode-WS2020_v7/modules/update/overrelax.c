@@ -0,0 +1,120 @@
+/*******************************************************************************
+ *
+ * File overrelax.c
+ *
+ * This software is distributed under the terms of the GNU General Public
+ * License (GPL)
+ *
+ * Includes the routines to perform microcanonical overrelaxation updates
+ * for pure gauge theory in SU(2) and SU(3).
+ *
+ * Externally accessible functions:
+ *
+ * double localOverrelaxationUpdate(double *f,int n,int dir,double *dplaq)
+ *        Performs one overrelaxation step for the link U_dir(n) of the gauge
+ *        field f. The link
+ *        (for SU(3) each of the three Cabibbo-Marinari subgroups) is
+ *        reflected about the projection of the staples to SU(2), such that
+ *        the action is left unchanged. No random numbers are used.
+ *        On return it hands back the fraction of links which have been
+ *        changed, i.e. 0 if the staples vanish and 1 otherwise. The change
+ *        of Re tr(U_dir(n)*staples), which only comes from rounding, is
+ *        added to *dplaq.
+ *
+ * For SU(2) with the staples A=k*V, where k=sqrt(det(A)) and V in SU(2),
+ * the reflected link is U'=V^dag*U^dag*V^dag. For SU(3) the SU(2)
+ * matrix r multiplying the link from the left, U'=r*U, is chosen as
+ * r=(V^dag)^2, where k*V is the SU(2) projection of the subgroup of U*A.
+ *
+ *******************************************************************************/
+
+#define OVERRELAX_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "headers.h"
+#include "modules.h"
+
+double localOverrelaxationUpdate(double *f, int n, int dir, double *dplaq)
+{
+    double sqrt_det, tr, tr_old;
+
+#if (SUN == 2)
+    su2mat A, U, T1, T2;
+
+    staples(f, n, dir, &A);
+    su2_det_sqrt(sqrt_det, A);
+
+    if (sqrt_det <= __DBL_EPSILON__)
+        return 0.0;
+
+    su2_dble_div(A, sqrt_det);
+
+    gf_get(U, f, n, dir);
+    su2_trace_mul(tr_old, U, A);
+    su2_mat_mul(T1, A, U);
+    su2_mat_mul(T2, T1, A);
+    su2_dag(U, T2); /*U = A^dag*U^dag*A^dag*/
+    gf_set(f, n, dir, U);
+    su2_trace_mul(tr, U, A);
+    *dplaq += sqrt_det * (tr - tr_old);
+
+    return 1.0;
+
+#elif (SUN == 3)
+    su3mat link, staple_sum, W, R, Temp;
+    su2mat sub, sub_dag, r;
+
+    staples(f, n, dir, &staple_sum);
+    gf_get(link, f, n, dir);
+    su3_trace_mul_re(tr_old, link, staple_sum);
+
+    for (int i = 1; i <= 3; i++)
+    {
+        su3_mat_mul(W, link, staple_sum);
+        switch (i)
+        {
+        case 1:
+            extr_sub1(sub, W);
+            break;
+        case 2:
+            extr_sub2(sub, W);
+            break;
+        case 3:
+            extr_sub3(sub, W);
+            break;
+        }
+        su2_det_sqrt(sqrt_det, sub);
+
+        if (sqrt_det <= __DBL_EPSILON__)
+            return 0.0;
+        su2_dble_div(sub, sqrt_det);
+
+        su2_dag(sub_dag, sub);
+        su2_mat_mul(r, sub_dag, sub_dag);
+
+        switch (i)
+        {
+        case 1:
+            create_su3_sub1(R, r);
+            break;
+        case 2:
+            create_su3_sub2(R, r);
+            break;
+        case 3:
+            create_su3_sub3(R, r);
+            break;
+        }
+
+        su3_mat_mul(Temp, R, link);
+        link = Temp;
+    }
+
+    gf_set(f, n, dir, link);
+    su3_trace_mul_re(tr, link, staple_sum);
+    *dplaq += tr - tr_old;
+
+    return 1.0;
+#endif
+}
@@ -12,14 +12,68 @@
  *
  * Externally accessible functions:
  *
- * void update(int iup,int nup,int utype,int stype)
- *      Performs nup sweeps of local updates of the type defined by utype.
+ * void gaugefieldUpdate(int iup,int nup,int utype,int stype)
+ *      Performs nup sweeps of local updates of the type defined by utype
+ *      on the gauge field pu of sublattice puSublattice (see headers.h).
  *      stype defines the sweep type.
  *
- * utype==1 : 1 Metropolis update
+ * void gaugefieldUpdateSublattice(double *f,int n_sl,int iup,int nup,
+ *                                 int utype,int stype)
+ *      As gaugefieldUpdate, but for the gauge field f of sublattice n_sl,
+ *      which labels the random number streams of its links. Sublattices
+ *      without common outer layers may be updated by different OpenMP
+ *      threads at the same time (see mf_colour.c), the checkerboard sweeps
+ *      then run on the calling thread only. With MASTER_FIELD 0 or
+ *      MPI_PARALLEL 1, where the plaquette is recomputed from pu and the
+ *      outer layers of pu are exchanged, f must be pu.
+ *
+ * utype==0 : 1 Metropolis update
+ * utype==1 : 1 heatbath update
+ * utype==2 : 1 heatbath sweep followed by runParams.numOverrelax
+ *            overrelaxation sweeps (the acceptance refers to the heatbath)
  *
  * stype==0 : Sweeps with all links in order of appearance
  * stype==1 : Sweeps with randomly chosen points
+ * stype==2 : Checkerboard sweeps. For each direction first all even and
+ *            then all odd points are updated. Links with the same
+ *            direction and parity do not share any staple, so that they
+ *            are distributed over the OpenMP threads, each of which uses
+ *            its own random number stream. The configurations are
+ *            reproducible for a fixed seed and number of threads.
+ *            With RNG_TYPE 1 (see headers.h) the configurations are
+ *            also independent of the number of threads and processes.
+ *            With MPI_PARALLEL 1 the links in the outer layers are
+ *            exchanged after every direction and parity (see mpi_comm.c).
+ *            The exchange runs while the points which are not on the
+ *            boundary of the core are updated, the boundary points are
+ *            updated after it has finished. The threads process batches
+ *            of RANDOM_SLOTS points (see headers.h), whose heatbath
+ *            updates are done together (see heatbath.c).
+ *
+ * double trackedPlaquette(void)
+ *      Returns the average plaquette of the gauge field (with MPI_PARALLEL 1
+ *      on all processes, with MASTER_FIELD 1 of the master field) after the
+ *      last call of gaugefieldUpdate, without a further pass over the links.
+ *
+ * void setTrackedPlaquette(double plaq)
+ *      Sets the average plaquette from which the changes are summed up, e.g.
+ *      to the one measured on the master field (see mf_meas.c).
+ *
+ * Every local update adds the change of Re tr(U_dir(n)*staples) of its link,
+ * i.e. of the summed real traces of the plaquettes, to the sum of the sweep,
+ * and gaugefieldUpdate adds the sums of its sweeps to a running total. The
+ * total is recomputed with plaquette() at the first call and after every
+ * PLAQ_RESYNC sweeps (see headers.h), which limits the drift from rounding
+ * and from the projection to SU(N). With MASTER_FIELD 1 and MPI_PARALLEL 0 f
+ * only holds one sublattice, the sums of all sublattices add up to the change
+ * of the master field and the total must be set by setTrackedPlaquette.
+ *
+ * The link U_dir(n) draws its random numbers from the stream
+ * (sweep,indexMF(n_sl,n),dir) (see philox.c and init.c), without master field
+ * from the stream (sweep,n,dir), where sweep counts the sweeps with random
+ * numbers, (iup-1)*nup+1,...,iup*nup. In random sweeps the streams are
+ * labelled by the point of the loop instead of the updated one, whose choice
+ * uses the stream (sweep,site,DIM).
  *
  *******************************************************************************/
 
@@ -28,130 +82,373 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
-#include "ranlxd.h"
 #include "headers.h"
 #include "modules.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* summed real traces of the plaquettes and number of sweeps since they were
+ * computed from the links, plaqSweeps<0 if they are not known */
+static double plaqSum = 0.0;
+static int plaqSweeps = -1;
+
+#if ((MASTER_FIELD == 1) && (MPI_PARALLEL == 0))
+/* changes of the sublattices which have not yet been added to plaqSum, such
+ * that concurrent updates of sublattices (MF_COLOUR 1) are added in a fixed
+ * order */
+static double plaqChange[VOL_SL];
+#endif
 
+/* index of the point n of sublattice n_sl on the whole lattice, which
+ * labels the random number streams */
 #if (MASTER_FIELD == 1)
-void gaugefieldUpdate(int iup, int nup, int utype, int stype)
+#define streamIndex(n_sl, n) indexMF((n_sl), (n))
+#else
+#define streamIndex(n_sl, n) ((long int)(n))
+#endif
+
+/* number of plaquettes times N of the (master) field */
+#if (MASTER_FIELD == 1)
+#define PLAQ_NORM ((double)(SUN * NPLAQ) * (double)(VOL_MF))
+#else
+#define PLAQ_NORM ((double)(SUN * NPLAQ * VOL))
+#endif
+
+/* Performs the local update of type ltype of the link U_dir(n) of f
+ * ltype==0 : Metropolis, ltype==1 : heatbath, ltype==2 : overrelaxation
+ * The random numbers are drawn from the stream (sweep,streamIndex(n_sl,m),dir),
+ * the change of the summed plaquette is added to *dplaq */
+static double localUpdate(double *f, int n_sl, int n, int m, int dir, int ltype, int sweep, double *dplaq)
 {
-    int n, in, dir, idir, nn;
-    double nsum, msum, r[2];
-    double iaccRate, t1, t2;
+#if (RNG_TYPE == 1)
+    if (ltype != 2)
+        randomStream(sweep, streamIndex(n_sl, m), dir);
+#endif
 
-    checkpoint("update -- in");
+    if (ltype == 0)
+        return localMetropolisUpdate(f, n, dir, 1, dplaq);
+    else if (ltype == 1)
+        return localHeatbathUpdate(f, n, dir, 1, dplaq);
+    else
+        return localOverrelaxationUpdate(f, n, dir, dplaq);
+}
 
-    error(utype != 0 && utype != 1, "update [update.c]", "Unknown update type! Only "
-                                                         "Metropolis (SIM_TYPE=0) and heatbath (SIM_TYPE=1) implemented!");
-    error(stype != 0 && stype != 1, "update [update.c]", "Unknown sweep type! "
-                                                         "Only sequential (SWEEP_TYPE=0) and random (SWEEP_TYPE=1) "
-                                                         "sweeps implemented!");
+/* Performs the local updates of type ltype of the nb<=RANDOM_SLOTS links
+ * U_dir(n[k]) of f, which must not share any staple. Heatbath updates are
+ * done together by heatbathUpdateLinks, the link n[k] draws its random
+ * numbers from the stream (sweep,streamIndex(n_sl,n[k]),dir) in slot k */
+static double updateBatch(double *f, int n_sl, int nb, int *n, int dir, int ltype, int sweep, double *dplaq)
+{
+    int k;
+    double nsum;
 
-    t1 = getTime();
+    if (ltype == 1)
+    {
+#if (RNG_TYPE == 1)
+        for (k = 0; k < nb; k++)
+            randomStreamSlot(k, sweep, streamIndex(n_sl, n[k]), dir);
+#endif
+        return heatbathUpdateLinks(f, nb, n, dir, dplaq);
+    }
 
-    msum = 0.;
-    for (nn = 0; nn < nup; nn++)
+    nsum = 0.;
+    for (k = 0; k < nb; k++)
+        nsum += localUpdate(f, n_sl, n[k], n[k], dir, ltype, sweep, dplaq);
+
+    return nsum;
+}
+
+/* number of points in the batch b of the points n0,..,n1-1 */
+#define batch_size(b, n0, n1) \
+    (((n1) - (n0) - (b) * RANDOM_SLOTS < RANDOM_SLOTS) ? ((n1) - (n0) - (b) * RANDOM_SLOTS) : RANDOM_SLOTS)
+
+#if (MPI_PARALLEL == 1)
+/* Performs one checkerboard sweep of f on the lattice of the process with
+ * nthreads threads, returns the summed acceptance. The exchange of the links
+ * of each direction is overlapped with the update of the interior points of
+ * the next parity. The time the threads spent updating links (without
+ * waiting) is added to *tbusy, the change of the summed plaquette to *dplaq */
+static double checkerboardSweep(double *f, int n_sl, int nthreads, int ltype, int sweep, double *tbusy,
+                                double *dplaq)
+{
+    double nsum, dsum;
+
+    nsum = 0.;
+    dsum = 0.;
+#pragma omp parallel num_threads(nthreads) reduction(+ : nsum, dsum)
     {
-        nsum = 0;
-        for (n = 0; n < VOL; n++)
+        int b, nint, nbint, nbext, dir, par, *lst;
+        double t1, tb;
+
+        tb = 0.;
+        for (dir = 0; dir < DIM; dir++)
         {
-            if (stype == 1)
+            for (par = 0; par < 2; par++)
             {
-                ranlxd(r, 1);
-                in = (int)(VOL * r[0]);
-                if (in == VOL)
-                    in = VOL - 1;
+                nint = checkerboardList(par, &lst);
+                nbint = (nint + RANDOM_SLOTS - 1) / RANDOM_SLOTS;
+                nbext = (VOL / 2 - nint + RANDOM_SLOTS - 1) / RANDOM_SLOTS;
+
+                t1 = getTime();
+#pragma omp for schedule(static) nowait
+                for (b = 0; b < nbint; b++)
+                    nsum += updateBatch(f, n_sl, batch_size(b, 0, nint), lst + b * RANDOM_SLOTS, dir, ltype, sweep,
+                                        &dsum);
+                tb += getTime() - t1;
+
+#pragma omp master
+                finishHaloExchange();
+#pragma omp barrier
+
+                t1 = getTime();
+#pragma omp for schedule(static)
+                for (b = 0; b < nbext; b++)
+                    nsum += updateBatch(f, n_sl, batch_size(b, nint, VOL / 2), lst + nint + b * RANDOM_SLOTS, dir,
+                                        ltype, sweep, &dsum);
+                tb += getTime() - t1;
+
+#pragma omp master
+                startHaloExchange(dir);
             }
-            else
-                in = n;
-            
-            in = i[in]; //only difference to non master-field sim
-            for (dir = 0; dir < DIM; dir++)
+        }
+
+#pragma omp atomic
+        *tbusy += tb;
+    }
+    finishHaloExchange();
+    *dplaq += dsum;
+
+    return nsum;
+}
+
+/* Projects the links of the core to SU(N) and refreshes the outer layers */
+static void projectCore(void)
+{
+    int n, dir;
+    sun_mat v;
+
+    for (n = 0; n < VOL; n++)
+    {
+        for (dir = 0; dir < DIM; dir++)
+        {
+            gf_get(v, pu, i[n], dir);
+#if (SUN == 2)
+            project_to_su2(&v);
+#elif (SUN == 3)
+            project_to_su3(&v);
+#endif
+            gf_set(pu, i[n], dir, v);
+        }
+    }
+    exchangeHalo();
+}
+#else
+/* Performs one checkerboard sweep of f with nthreads threads, returns the
+ * summed acceptance. The time the threads spent updating links (without
+ * waiting) is added to *tbusy, the change of the summed plaquette to *dplaq */
+static double checkerboardSweep(double *f, int n_sl, int nthreads, int ltype, int sweep, double *tbusy,
+                                double *dplaq)
+{
+    double nsum, dsum;
+
+    nsum = 0.;
+    dsum = 0.;
+#pragma omp parallel num_threads(nthreads) reduction(+ : nsum, dsum)
+    {
+        int b, k, n0, nb, dir, par, in[RANDOM_SLOTS];
+        double t1, tb;
+
+        tb = 0.;
+        for (dir = 0; dir < DIM; dir++)
+        {
+            for (par = 0; par < 2; par++)
             {
-                if (stype == 1)
+                t1 = getTime();
+#pragma omp for schedule(static) nowait
+                for (b = 0; b < (VOL / 2 + RANDOM_SLOTS - 1) / RANDOM_SLOTS; b++)
                 {
-                    idir = (int)(DIM * r[1]);
-                    if (idir == DIM)
-                        idir = DIM - 1;
+                    n0 = par * (VOL / 2) + b * RANDOM_SLOTS;
+                    nb = batch_size(b, 0, VOL / 2);
+                    for (k = 0; k < nb; k++)
+                    {
+#if (MASTER_FIELD == 1)
+                        in[k] = i[ieo[n0 + k]];
+#else
+                        in[k] = ieo[n0 + k];
+#endif
+                    }
+                    nsum += updateBatch(f, n_sl, nb, in, dir, ltype, sweep, &dsum);
                 }
-                else
-                    idir = dir;
+                tb += getTime() - t1;
+#pragma omp barrier
+            }
+        }
+
+#pragma omp atomic
+        *tbusy += tb;
+    }
+    *dplaq += dsum;
+
+    return nsum;
+}
+#endif
+
+static void logSweepScaling(int nup, int nthreads, double time, double tbusy)
+{
+    logging("checkerboard sweep took %.9f seconds on %d threads\n"
+            "(%.3e link updates/s; %.3e per thread; parallel efficiency %.3f)\n",
+            time / nup, nthreads, (double)(nup) * VOL * DIM / time,
+            (double)(nup) * VOL * DIM / time / nthreads, tbusy / (nthreads * time));
+}
+
+/* Performs one sequential (stype==0) or random (stype==1) sweep of f,
+ * returns the summed acceptance and adds the change of the summed plaquette
+ * to *dplaq */
+static double localSweep(double *f, int n_sl, int ltype, int stype, int sweep, double *dplaq)
+{
+    int n, in, m, dir, idir;
+    double nsum, r[2];
 
-                if (utype == 0)
-                    nsum += localMetropolisUpdate(in, dir, 1);
-                else if (utype == 1)
-                    nsum += localHeatbathUpdate(in, dir, 1);
+    nsum = 0;
+    for (n = 0; n < VOL; n++)
+    {
+#if (MASTER_FIELD == 1)
+        m = i[n];
+#else
+        m = n;
+#endif
+        if (stype == 1)
+        {
+            randomStream(sweep, streamIndex(n_sl, m), DIM);
+            randomNumbers(r, 1);
+            in = (int)(VOL * r[0]);
+            if (in == VOL)
+                in = VOL - 1;
+        }
+        else
+            in = n;
+#if (MASTER_FIELD == 1)
+        in = i[in]; //only difference to non master-field sim
+#endif
+        for (dir = 0; dir < DIM; dir++)
+        {
+            if (stype == 1)
+            {
+                idir = (int)(DIM * r[1]);
+                if (idir == DIM)
+                    idir = DIM - 1;
             }
+            else
+                idir = dir;
+
+            nsum += localUpdate(f, n_sl, in, m, dir, ltype, sweep, dplaq);
         }
+    }
+
+    return nsum;
+}
 
-        msum += nsum / (VOL * DIM);
+double trackedPlaquette(void)
+{
+    error(plaqSweeps < 0, "trackedPlaquette [update.c]", "The summed plaquette is not known!");
+
+#if ((MASTER_FIELD == 1) && (MPI_PARALLEL == 0))
+    int k;
+
+    for (k = 0; k < VOL_SL; k++)
+    {
+        plaqSum += plaqChange[k];
+        plaqChange[k] = 0.0;
     }
-    iaccRate = msum / nup;
-    project_gfield_to_sun(pu); //?????
+#endif
 
-    t2 = getTime();
+    return plaqSum / PLAQ_NORM;
+}
 
-    logging("\nUpdate %d done:\n"
-            "(algorithm %d; sweep %d; acc=%.3f)\n"
-            "update took %.9f seconds\n",
-            iup, utype, stype, iaccRate, t2 - t1);
+void setTrackedPlaquette(double plaq)
+{
+#if ((MASTER_FIELD == 1) && (MPI_PARALLEL == 0))
+    int k;
 
-    checkpoint("update -- out");
+    for (k = 0; k < VOL_SL; k++)
+        plaqChange[k] = 0.0;
+#endif
+
+    plaqSum = plaq * PLAQ_NORM;
+    plaqSweeps = 0;
 }
-#elif (MASTER_FIELD == 0)
-void gaugefieldUpdate(int iup, int nup, int utype, int stype)
+
+void gaugefieldUpdateSublattice(double *f, int n_sl, int iup, int nup, int utype, int stype)
 {
-    int n, in, dir, idir, nn;
-    double nsum, msum, r[2];
-    double iaccRate, t1, t2;
+    int nn, io, nor, ltype, sweep, nthreads;
+    double nsum, msum, dplaq;
+    double iaccRate, t1, t2, tbusy;
 
     checkpoint("update -- in");
 
-    error(utype != 0 && utype != 1, "update [update.c]", "Unknown update type! Only "
-                                                         "Metropolis (SIM_TYPE=0) and heatbath (SIM_TYPE=1) implemented!");
-    error(stype != 0 && stype != 1, "update [update.c]", "Unknown sweep type! "
-                                                         "Only sequential (SWEEP_TYPE=0) and random (SWEEP_TYPE=1) "
-                                                         "sweeps implemented!");
+    error(utype != 0 && utype != 1 && utype != 2, "update [update.c]", "Unknown update type! Only "
+                                                                       "Metropolis (SIM_TYPE=0), heatbath (SIM_TYPE=1) and heatbath "
+                                                                       "with overrelaxation (SIM_TYPE=2) implemented!");
+    error(stype != 0 && stype != 1 && stype != 2, "update [update.c]", "Unknown sweep type! "
+                                                                       "Only sequential (SWEEP_TYPE=0), random (SWEEP_TYPE=1) "
+                                                                       "and checkerboard (SWEEP_TYPE=2) sweeps implemented!");
 
     t1 = getTime();
 
+#ifdef _OPENMP
+    /* nested regions would oversubscribe the threads */
+    nthreads = omp_in_parallel() ? 1 : omp_get_max_threads();
+#else
+    nthreads = 1;
+#endif
+
+#if ((MASTER_FIELD == 0) || (MPI_PARALLEL == 1))
+    error(f != pu, "update [update.c]", "The gauge field must be pu!");
+    if ((plaqSweeps < 0) || (plaqSweeps >= PLAQ_RESYNC))
+        setTrackedPlaquette(plaquette());
+#endif
+
     msum = 0.;
+    tbusy = 0.;
+    dplaq = 0.;
+    nor = (utype == 2) ? runParams.numOverrelax : 0;
     for (nn = 0; nn < nup; nn++)
     {
-        nsum = 0;
-        for (n = 0; n < VOL; n++)
+        sweep = (iup - 1) * nup + nn + 1;
+        for (io = 0; io <= nor; io++)
         {
-            if (stype == 1)
-            {
-                ranlxd(r, 1);
-                in = (int)(VOL * r[0]);
-                if (in == VOL)
-                    in = VOL - 1;
-            }
+            if (io > 0)
+                ltype = 2;
             else
-                in = n;
-            for (dir = 0; dir < DIM; dir++)
-            {
-                if (stype == 1)
-                {
-                    idir = (int)(DIM * r[1]);
-                    if (idir == DIM)
-                        idir = DIM - 1;
-                }
-                else
-                    idir = dir;
+                ltype = (utype == 2) ? 1 : utype;
 
-                if (utype == 0)
-                    nsum += localMetropolisUpdate(in, dir, 1);
-                else if (utype == 1)
-                    nsum += localHeatbathUpdate(in, dir, 1);
-            }
-        }
+            if (stype == 2)
+                nsum = checkerboardSweep(f, n_sl, nthreads, ltype, sweep, &tbusy, &dplaq);
+            else
+                nsum = localSweep(f, n_sl, ltype, stype, sweep, &dplaq);
 
-        msum += nsum / (VOL * DIM);
+#if (MPI_PARALLEL == 1)
+            nsum = mpiGlobalSum(nsum) / VOL_SL;
+#endif
+            if (io == 0)
+                msum += nsum / (VOL * DIM);
+        }
     }
     iaccRate = msum / nup;
-    project_gfield_to_sun(pu);
+#if (MPI_PARALLEL == 1)
+    projectCore();
+    dplaq = mpiGlobalSum(dplaq);
+#else
+    project_gfield_to_sun(f);
+#endif
+
+#if ((MASTER_FIELD == 1) && (MPI_PARALLEL == 0))
+    plaqChange[n_sl] += dplaq;
+#else
+    plaqSum += dplaq;
+    plaqSweeps += nup;
+#endif
 
     t2 = getTime();
 
@@ -159,7 +456,13 @@ void gaugefieldUpdate(int iup, int nup, int utype, int stype)
             "(algorithm %d; sweep %d; acc=%.3f)\n"
             "update took %.9f seconds\n",
             iup, utype, stype, iaccRate, t2 - t1);
+    if (stype == 2)
+        logSweepScaling(nup * (nor + 1), nthreads, t2 - t1, tbusy);
 
     checkpoint("update -- out");
 }
-#endif
\ No newline at end of file
+
+void gaugefieldUpdate(int iup, int nup, int utype, int stype)
+{
+    gaugefieldUpdateSublattice(pu, puSublattice, iup, nup, utype, stype);
+}